@@ -1,6 +1,10 @@
 #include "chess.h"
 #include "data.h"
-/* last modified 02/26/14 */
+#if defined(UNIX)
+#  include <sys/mman.h>
+#  include <sys/wait.h>
+#endif
+/* last modified 10/19/26 */
 /*
  *******************************************************************************
  *                                                                             *
@@ -66,6 +70,13 @@
  *   game or after displaying n moves, whichever comes first.  If you use -n,  *
  *   then it will display n moves regardless of where the game move ranks.     *
  *                                                                             *
+ *   If "annotatemt=n" has been set (Unix only), the games in the file are     *
+ *   annotated by n worker processes at the same time, each one a serial       *
+ *   search that claims the next un-annotated game from a shared counter.  A   *
+ *   worker writes each game it annotates to a file of its own, and the parent *
+ *   copies these into the output file in the original game order, so the      *
+ *   result is the same as a normal one-game-at-a-time run.                    *
+ *                                                                             *
  *******************************************************************************
  */
 #define MIN_DECISIVE_ADV 150
@@ -74,13 +85,15 @@
 void Annotate() {
   FILE *annotate_in, *annotate_out;
   char text[128], tbuffer[4096], colors[32] = { "" }, pname[128] = {
-  ""};
+  ""}, inname[128], outname[128];
   int annotate_margin, annotate_score[100], player_score, best_moves,
       annotate_wtm;
   int annotate_search_time_limit, search_player;
   int twtm, path_len, analysis_printed = 0;
   int wtm, move_num, line1, line2, move, suggested, i;
-  int searches_done, read_status;
+  int searches_done, read_status, positions = 0, game_index = -1;
+  int workers = 0, worker = 0, owned = 1;
+  unsigned start;
   PATH temp[100], player_pv;
   int temp_search_depth;
   TREE *const tree = block[0];
@@ -88,6 +101,13 @@ void Annotate() {
   int save_swindle_mode;
   int html_mode = 0;
   int latex = 0;
+#if defined(UNIX)
+  FILE *null_out = 0;
+  volatile int *next_game = 0;
+  int fds[2], report[2], claimed = -1, ngames = 0, next_print = 0, max_game =
+      -1, last_game;
+  char *done = 0;
+#endif
 
 /*
  ************************************************************
@@ -113,7 +133,8 @@ void Annotate() {
         ("usage: annotate <file> <color> <moves> <margin> <time> [nmoves]\n");
     return;
   }
-  annotate_in = fopen(args[1], "r");
+  strcpy(inname, args[1]);
+  annotate_in = fopen(inname, "r");
   if (annotate_in == NULL) {
     Print(4095, "unable to open %s for input\n", args[1]);
     return;
@@ -126,6 +147,7 @@ void Annotate() {
     strcpy(text + strlen(text), ".tex");
   else
     strcpy(text + strlen(text), ".can");
+  strcpy(outname, text);
   annotate_out = fopen(text, "w");
   if (annotate_out == NULL) {
     Print(4095, "unable to open %s for output\n", text);
@@ -174,6 +196,107 @@ void Annotate() {
   read_status = ReadPGN(0, 0);
   read_status = ReadPGN(annotate_in, 0);
   player_pv.path[1] = 0;
+  start = ReadClock();
+/*
+ ************************************************************
+ *                                                          *
+ *  If we are using worker processes, start them now.  The  *
+ *  workers each run the normal annotation loop below, but  *
+ *  only search the games they claim.  The parent does no   *
+ *  searching at all, it just waits for each game to be     *
+ *  finished and copies the games to the output file in     *
+ *  order.                                                  *
+ *                                                          *
+ ************************************************************
+ */
+#if defined(UNIX)
+  if (annotate_workers > 1) {
+    next_game =
+        (volatile int *) mmap(0, 2 * sizeof(int), PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_ANON, -1, 0);
+    if (next_game != MAP_FAILED && !pipe(fds)) {
+      next_game[0] = 0;
+      next_game[1] = 0;
+      fflush(annotate_out);
+      fflush(stdout);
+      if (log_file)
+        fflush(log_file);
+      for (workers = 0; workers < annotate_workers; workers++) {
+        pid_t pid = fork();
+
+        if (pid < 0) {
+          Print(2048, "ERROR.  fork() failed, using %d workers.\n", workers);
+          break;
+        }
+        if (!pid) {
+          close(fds[0]);
+          InitializeWorker(annotate_workers);
+          fclose(annotate_out);
+          fclose(annotate_in);
+          annotate_out = null_out = fopen("/dev/null", "w");
+          annotate_in = fopen(inname, "r");
+          if (!annotate_out || !annotate_in)
+            _exit(1);
+          read_status = ReadPGN(0, 0);
+          read_status = ReadPGN(annotate_in, 0);
+          worker = 1;
+          owned = 0;
+          break;
+        }
+      }
+      if (!worker) {
+        close(fds[1]);
+        Print(4095, "annotating using %d worker processes.\n", workers);
+        while (read(fds[0], report, sizeof(report)) == sizeof(report)) {
+          if (report[0] >= ngames) {
+            done = (char *) realloc(done, report[0] + 1024);
+            memset(done + ngames, 0, report[0] + 1024 - ngames);
+            ngames = report[0] + 1024;
+          }
+          done[report[0]] = 1;
+          max_game = Max(max_game, report[0]);
+          positions += report[1];
+          Print(4095, "game %d annotated (%d positions).\n", report[0] + 1,
+              report[1]);
+          for (; next_print <= max_game && done[next_print]; next_print++)
+            AnnotateCopyGame(annotate_out, outname, next_print);
+        }
+        close(fds[0]);
+        while (wait(0) > 0);
+/*
+ ************************************************************
+ *                                                          *
+ *  If a worker died, the copy loop above stopped at the    *
+ *  game it never finished.  Games finished after that one  *
+ *  are still waiting in their own files, so copy those in  *
+ *  order now.  Report every game that was claimed but      *
+ *  never finished and remove its partial file.  A claim    *
+ *  past the last game in the file is not a game, so stop   *
+ *  at the game count a worker that read the whole file     *
+ *  left behind.                                            *
+ *                                                          *
+ ************************************************************
+ */
+        last_game = next_game[0] - 1;
+        if (next_game[1])
+          last_game = Min(last_game, next_game[1] - 1);
+        for (; next_print <= last_game; next_print++)
+          if (next_print <= max_game && done[next_print])
+            AnnotateCopyGame(annotate_out, outname, next_print);
+          else {
+            Print(2048, "ERROR.  game %d was not annotated, worker failed.\n",
+                next_print + 1);
+            sprintf(text, "%s.%d", outname, next_print);
+            remove(text);
+          }
+        free(done);
+        munmap((void *) next_game, 2 * sizeof(int));
+        read_status = -1;
+      }
+    } else
+      Print(2048, "ERROR.  unable to start annotate workers.\n");
+  }
+#endif
   while (read_status != -1) {
     ponder_move = 0;
     last_pv.pathd = 0;
@@ -200,7 +323,33 @@ void Annotate() {
     while (read_status == 1);
     if (read_status == -1)
       break;
-    if (latex == 0) {
+/*
+ ************************************************************
+ *                                                          *
+ *  A worker process claims games from the shared counter.  *
+ *  A game it did not claim is simply played through with   *
+ *  no searches and no output.  A game it did claim is      *
+ *  written to its own file, named after the output file    *
+ *  plus the game number, for the parent to pick up.        *
+ *                                                          *
+ ************************************************************
+ */
+    game_index++;
+#if defined(UNIX)
+    if (worker) {
+      if (claimed < game_index)
+        claimed = __sync_fetch_and_add(next_game, 1);
+      owned = claimed == game_index;
+      if (owned) {
+        sprintf(text, "%s.%d", outname, game_index);
+        annotate_out = fopen(text, "w");
+        if (!annotate_out)
+          _exit(1);
+        positions = 0;
+      }
+    }
+#endif
+    if (owned && latex == 0) {
       fprintf(annotate_out, "[Event \"%s\"]%s\n", pgn_event, html_br);
       fprintf(annotate_out, "[Site \"%s\"]%s\n", pgn_site, html_br);
       fprintf(annotate_out, "[Date \"%s\"]%s\n", pgn_date, html_br);
@@ -229,7 +378,7 @@ void Annotate() {
           DisplayEvaluationKibitz(annotate_margin, wtm), html_br);
       fprintf(annotate_out, "{search time limit is %s}%s\n%s\n",
           DisplayTimeKibitz(annotate_search_time_limit), html_br, html_br);
-    } else {
+    } else if (owned) {
       fprintf(annotate_out, "\\textbf{\\sc %s %s -- %s %s}%s\n", pgn_white,
           pgn_white_elo, pgn_black, pgn_black_elo, html_br);
       fprintf(annotate_out, "{\\em %s, %s}%s\n", pgn_site, pgn_date, html_br);
@@ -238,7 +387,9 @@ void Annotate() {
       fprintf(annotate_out, "\\begin{mainline}{%s}{Crafty v%s}\n", pgn_result,
           version);
     }
-    if (strlen(colors)) {
+    if (!owned)
+      annotate_wtm = -1;
+    else if (strlen(colors)) {
       if (!strcmp(colors, "w"))
         annotate_wtm = 1;
       else if (!strcmp(colors, "b"))
@@ -250,6 +401,8 @@ void Annotate() {
       else {
         Print(4095, "invalid color specification, retry\n");
         fclose(annotate_out);
+        if (worker)
+          _exit(1);
         return;
       }
     } else {
@@ -260,6 +413,8 @@ void Annotate() {
       else {
         Print(4095, "Player name doesn't match any PGN name tag, retry\n");
         fclose(annotate_out);
+        if (worker)
+          _exit(1);
         return;
       }
     }
@@ -289,6 +444,7 @@ void Annotate() {
       analysis_printed = 0;
       if (move_number >= line1 && move_number <= line2) {
         if (annotate_wtm == 2 || annotate_wtm == wtm) {
+          positions++;
           last_pv.pathd = 0;
           last_pv.pathl = 0;
           thinking = 1;
@@ -441,7 +597,7 @@ void Annotate() {
       read_status = ReadPGN(annotate_in, 1);
       while (read_status == 2) {
         suggested = InputMove(tree, 0, wtm, 1, 0, buffer);
-        if (suggested > 0) {
+        if (suggested > 0 && owned) {
           thinking = 1;
           Print(4095, "\n              Searching only the move suggested.");
           Print(4095, "--------------------\n");
@@ -521,7 +677,27 @@ void Annotate() {
       fprintf(annotate_out, " } \\end{flushright}");
       AnnotateFooterTeX(annotate_out);
     }
+#if defined(UNIX)
+    if (worker && owned) {
+      fclose(annotate_out);
+      annotate_out = null_out;
+      report[0] = game_index;
+      report[1] = positions;
+      if (write(fds[1], report, sizeof(report)) != sizeof(report))
+        _exit(1);
+    }
+#endif
   }
+#if defined(UNIX)
+  if (worker) {
+    next_game[1] = game_index + 1;
+    close(fds[1]);
+    _exit(0);
+  }
+#endif
+  Print(4095, "annotated %d positions in %s (%d positions/hour).\n",
+      positions, DisplayTime(ReadClock() - start),
+      (int) ((uint64_t) positions * 360000 / Max(1, ReadClock() - start)));
   if (annotate_out)
     fclose(annotate_out);
   if (annotate_in)
@@ -531,6 +707,29 @@ void Annotate() {
   swindle_mode = save_swindle_mode;
 }
 
+/*
+ *******************************************************************************
+ *                                                                             *
+ *   AnnotateCopyGame() appends the game an annotate worker wrote to its own   *
+ *   file (the output file name plus the game number) to the output file,      *
+ *   then removes the worker's file.                                           *
+ *                                                                             *
+ *******************************************************************************
+ */
+void AnnotateCopyGame(FILE * annotate_out, char *outname, int game) {
+  FILE *game_in;
+  char text[128], copy_buffer[4096];
+  size_t bytes;
+
+  sprintf(text, "%s.%d", outname, game);
+  if ((game_in = fopen(text, "r"))) {
+    while ((bytes = fread(copy_buffer, 1, 4096, game_in)))
+      fwrite(copy_buffer, 1, bytes, annotate_out);
+    fclose(game_in);
+    remove(text);
+  }
+}
+
 /*
  *******************************************************************************
  *                                                                             *
@@ -1,6 +1,7 @@
+#include <math.h>
 #include "chess.h"
 #include "data.h"
-/* last modified 08/26/15 */
+/* last modified 10/19/26 */
 /*
  *******************************************************************************
  *                                                                             *
@@ -41,13 +42,33 @@
  *   multiples of accuracy times longer.  Best results are likely obtained     *
  *   with a larger accuracy setting, but it needs to run overnight.            *
  *                                                                             *
+ *   The extended form of the command is                                       *
+ *                                                                             *
+ *         autotune time accuracy full [maxhash]                               *
+ *                                                                             *
+ *   which is intended for setting up a new machine with no user choices made  *
+ *   yet.  Before tuning the SMP controls as above, it also sweeps the number  *
+ *   of threads (1, 2, 4, ... up to the number of processors) and the hash     *
+ *   table size (16M, 64M, ... up to maxhash, default 1G) and picks the best   *
+ *   of each.  It fits the thread times to Amdahl's law to estimate the        *
+ *   serial fraction of the search, and fits the stage I times to an           *
+ *   exponential time-to-depth curve to estimate the effective branching       *
+ *   factor and the depth expected at the target time.  smpmt and hash are     *
+ *   added to .craftyrc along with the SMP controls, and everything is also    *
+ *   written to "autotune.json" so that it can be read by a script.            *
+ *                                                                             *
  *******************************************************************************
  */
 void AutoTune(int nargs, char *args[]) {
   unsigned int target_time = 3000, accuracy = 4, atstart, atend;
   unsigned int time, current, setting[64], times[64], last_time, stageii;
-  int benchd, i, v, p, best, bestv, samples;
-  FILE *craftyrc = fopen(".craftyrc", "a");
+  unsigned int depth_times[16], thread_times[16], hash_times[16], tuned[16];
+  int benchd, i, v, p, best, bestv, samples, full = 0, depths = 0;
+  int threads[16], nthreads = 0, nhash = 0, best_thread = 0, best_hash = 0;
+  uint64_t hash_sizes[16], max_hash = 1ull << 30, size;
+  double sx = 0, sy = 0, sxx = 0, sxy = 0, n = 0, x, y, ebf = 0, serial = 0;
+  double depth_target = 0;
+  FILE *craftyrc = fopen(".craftyrc", "a"), *json;
 
 /*
  ************************************************************
@@ -56,17 +77,25 @@ void AutoTune(int nargs, char *args[]) {
  *                                                          *
  ************************************************************
  */
-  if (smp_max_threads < 2) {
-    Print(4095, "ERROR: smpmt must be set to > 1 for tuning to work\n");
-    fclose(craftyrc);
-    return;
-  }
   if (nargs > 1)
     target_time = atoi(args[1]) * 100;
   if (nargs > 2)
     accuracy = atoi(args[2]);
-  Print(4095, "AutoTune()  time=%s  accuracy=%d\n",
-      DisplayHHMMSS(target_time), accuracy);
+  if (nargs > 3 && !strcmp(args[3], "full"))
+    full = 1;
+  if (nargs > 4)
+    max_hash = Max(atoiKMB(args[4]), 64 * 1024);
+  if (full && smp_max_threads < 2 && Min(hardware_processors, CPUS) > 1) {
+    sprintf(buffer, "smpmt=%d", Min(hardware_processors, CPUS));
+    Option(block[0]);
+  }
+  if (!full && smp_max_threads < 2) {
+    Print(4095, "ERROR: smpmt must be set to > 1 for tuning to work\n");
+    fclose(craftyrc);
+    return;
+  }
+  Print(4095, "AutoTune()  time=%s  accuracy=%d%s\n",
+      DisplayHHMMSS(target_time), accuracy, (full) ? "  full" : "");
 /*
  ************************************************************
  *                                                          *
@@ -78,6 +107,9 @@ void AutoTune(int nargs, char *args[]) {
  *  bench takes more than 6x this time limit and use the    *
  *  previous value which just fit inside the limit.         *
  *                                                          *
+ *  The times are also saved so that we can fit the time    *
+ *  to depth curve once we are done.                        *
+ *                                                          *
  ************************************************************
  */
   atstart = ReadClock();
@@ -100,6 +132,7 @@ void AutoTune(int nargs, char *args[]) {
     for (v = 0; v < accuracy; v++)
       time += Bench(benchd, 1);
     time /= accuracy;
+    depth_times[depths++] = time;
     Print(4095, " ->%s\n", DisplayHHMMSS(time));
     if (time > 6 * target_time)
       break;
@@ -110,6 +143,114 @@ void AutoTune(int nargs, char *args[]) {
   atend = ReadClock();
   Print(4095, "Actual runtime for Stage I: %s\n",
       DisplayHHMMSS(atend - atstart));
+/*
+ ************************************************************
+ *                                                          *
+ *  Fit the stage I times to time = a * ebf ^ depth with a  *
+ *  least squares fit of log(time) against depth.  Times    *
+ *  under 1/10th of a second are too noisy to be useful.    *
+ *  The fit gives the effective branching factor, and the   *
+ *  depth where the average time per position (the bench    *
+ *  searches 64 of them) reaches the target time.           *
+ *                                                          *
+ ************************************************************
+ */
+  for (i = 0; i < depths; i++)
+    if (depth_times[i] >= 10) {
+      x = i - 5;
+      y = log((double) depth_times[i]);
+      n++;
+      sx += x;
+      sy += y;
+      sxx += x * x;
+      sxy += x * y;
+    }
+  if (n > 1 && n * sxx - sx * sx > 0) {
+    y = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+    x = (sy - y * sx) / n;
+    ebf = exp(y);
+    if (y > 0)
+      depth_target = 16 + (log(64.0 * target_time) - x) / y;
+    Print(4095, "Effective branching factor: %.2f\n", ebf);
+    Print(4095, "Expected depth at target time: %.1f\n", depth_target);
+  }
+/*
+ ************************************************************
+ *                                                          *
+ *  For the full tune, we now sweep the thread count and    *
+ *  the hash size, using the benchmark setting from stage I *
+ *  to measure time to depth.  For threads we try 1, 2, 4,  *
+ *  and so forth up to the number of processors, and fit    *
+ *  the times to Amdahl's law,                              *
+ *                                                          *
+ *     time(n) / time(1) = s + (1 - s) / n                  *
+ *                                                          *
+ *  to estimate the serial fraction s.  For hash we try 16M *
+ *  and each 4x step up to maxhash.  In both cases we use   *
+ *  the setting that produced the shortest time.            *
+ *                                                          *
+ ************************************************************
+ */
+  if (full) {
+    Print(4095, "\nBegin thread sweep.\n");
+    for (current = 1; current < smp_max_threads && nthreads < 15;
+        current *= 2)
+      threads[nthreads++] = current;
+    threads[nthreads++] = Max(1, smp_max_threads);
+    for (i = 0; i < nthreads; i++) {
+      sprintf(buffer, "smpmt=%d", (threads[i] > 1) ? threads[i] : 0);
+      Option(block[0]);
+      Print(4095, "Testing %d threads: ", threads[i]);
+      time = 0;
+      for (p = 0; p < accuracy; p++)
+        time += Bench(benchd, 1);
+      time /= accuracy;
+      thread_times[i] = Max(time, 1);
+      Print(4095, " ->%s  speedup=%.2f\n", DisplayHHMMSS(time),
+          (double) thread_times[0] / thread_times[i]);
+      if (thread_times[i] < thread_times[best_thread])
+        best_thread = i;
+    }
+    sxx = 0;
+    sxy = 0;
+    for (i = 1; i < nthreads; i++) {
+      x = 1.0 - 1.0 / threads[i];
+      y = (double) thread_times[i] / thread_times[0] - 1.0 / threads[i];
+      sxx += x * x;
+      sxy += x * y;
+    }
+    if (sxx > 0)
+      serial = Min(1.0, Max(0.0, sxy / sxx));
+    Print(4095, "Estimated serial fraction: %.3f\n", serial);
+    sprintf(buffer, "smpmt=%d",
+        (threads[best_thread] > 1) ? threads[best_thread] : 0);
+    Option(block[0]);
+    fprintf(craftyrc, "%s\n", buffer);
+    Print(4095, "adding " "%s" " to .craftyrc file.\n", buffer);
+    Print(4095, "\nBegin hash sweep.\n");
+    for (size = 16 * 1024 * 1024; size <= max_hash && nhash < 16; size *= 4)
+      hash_sizes[nhash++] = size;
+    if (!nhash)
+      hash_sizes[nhash++] = max_hash;
+    for (i = 0; i < nhash; i++) {
+      sprintf(buffer, "hash=%" PRIu64, hash_sizes[i]);
+      Option(block[0]);
+      Print(4095, "Testing hash=%s: ", DisplayKMB(hash_sizes[i], 1));
+      time = 0;
+      for (p = 0; p < accuracy; p++)
+        time += Bench(benchd, 1);
+      time /= accuracy;
+      hash_times[i] = time;
+      Print(4095, " ->%s\n", DisplayHHMMSS(time));
+      if (hash_times[i] < hash_times[best_hash])
+        best_hash = i;
+    }
+    sprintf(buffer, "hash=%" PRIu64, hash_sizes[best_hash]);
+    Option(block[0]);
+    fprintf(craftyrc, "hash=%s\n", DisplayKMB(hash_sizes[best_hash], 1));
+    Print(4095, "adding " "hash=%s" " to .craftyrc file.\n",
+        DisplayKMB(hash_sizes[best_hash], 1));
+  }
   Print(4095, "New estimated run time (stage II) is %s.\n",
       DisplayHHMMSS(accuracy * stageii * last_time));
   Print(4095, "\nBegin stage II (SMP testing).\n");
@@ -128,11 +269,18 @@ void AutoTune(int nargs, char *args[]) {
  *  parameter, and continue until we try the max value that *
  *  is allowed.  We choose the parameter value that used    *
  *  the least amount of time which optimizes this value for *
- *  minimum time-to-depth.                                  *
+ *  minimum time-to-depth, and leave it set while the next  *
+ *  parameter is tuned.                                     *
+ *                                                          *
+ *  If the thread sweep settled on one thread, there is     *
+ *  nothing to tune here.                                   *
  *                                                          *
  ************************************************************
  */
   for (v = 0; v < autotune_params; v++) {
+    tuned[v] = *tune[v].parameter;
+    if (smp_max_threads < 2)
+      continue;
     Print(4095, "auto-tuning %s (%d ~ %d by %d)\n", tune[v].description,
         tune[v].min, tune[v].max, tune[v].increment);
     current = *tune[v].parameter;
@@ -161,6 +309,8 @@ void AutoTune(int nargs, char *args[]) {
         bestv = times[i];
         best = i;
       }
+    *tune[v].parameter = setting[best];
+    tuned[v] = setting[best];
     fprintf(craftyrc, "%s=%d\n", tune[v].command, setting[best]);
     Print(4095, "adding " "%s=%d" " to .craftyrc file.\n", tune[v].command,
         setting[best]);
@@ -168,4 +318,55 @@ void AutoTune(int nargs, char *args[]) {
   atend = ReadClock();
   Print(4095, "Runtime for StageII: %s\n", DisplayHHMMSS(atend - atstart));
   fclose(craftyrc);
+/*
+ ************************************************************
+ *                                                          *
+ *  Last, write everything we measured to autotune.json so  *
+ *  that provisioning scripts do not have to scrape the     *
+ *  log.  Times are in seconds.                             *
+ *                                                          *
+ ************************************************************
+ */
+  json = fopen("autotune.json", "w");
+  if (!json) {
+    Print(4095, "ERROR: unable to open autotune.json for output\n");
+    return;
+  }
+  fprintf(json, "{\n  \"target_time\": %.2f,\n", target_time / 100.0);
+  fprintf(json, "  \"accuracy\": %d,\n", accuracy);
+  fprintf(json, "  \"bench_depth\": %d,\n", benchd);
+  fprintf(json, "  \"time_to_depth\": {\n");
+  fprintf(json, "    \"ebf\": %.3f,\n", ebf);
+  fprintf(json, "    \"target_depth\": %.1f,\n", depth_target);
+  fprintf(json, "    \"samples\": [");
+  for (i = 0; i < depths; i++)
+    fprintf(json, "%s\n      {\"bench\": %d, \"time\": %.2f}",
+        (i) ? "," : "", i - 5, depth_times[i] / 100.0);
+  fprintf(json, "\n    ]\n  },\n");
+  if (full) {
+    fprintf(json, "  \"threads\": {\n");
+    fprintf(json, "    \"serial_fraction\": %.4f,\n", serial);
+    fprintf(json, "    \"samples\": [");
+    for (i = 0; i < nthreads; i++)
+      fprintf(json,
+          "%s\n      {\"threads\": %d, \"time\": %.2f, \"speedup\": %.3f}",
+          (i) ? "," : "", threads[i], thread_times[i] / 100.0,
+          (double) thread_times[0] / thread_times[i]);
+    fprintf(json, "\n    ]\n  },\n");
+    fprintf(json, "  \"hash\": {\n    \"samples\": [");
+    for (i = 0; i < nhash; i++)
+      fprintf(json, "%s\n      {\"bytes\": %" PRIu64 ", \"time\": %.2f}",
+          (i) ? "," : "", hash_sizes[i], hash_times[i] / 100.0);
+    fprintf(json, "\n    ]\n  },\n");
+  }
+  fprintf(json, "  \"settings\": {\n");
+  fprintf(json, "    \"smpmt\": %d,\n", Max(1, smp_max_threads));
+  fprintf(json, "    \"hash\": %" PRIu64 ",\n",
+      (uint64_t) hash_table_size * sizeof(HASH_ENTRY));
+  for (v = 0; v < autotune_params; v++)
+    fprintf(json, "    \"%s\": %d%s\n", tune[v].command, tuned[v],
+        (v < autotune_params - 1) ? "," : "");
+  fprintf(json, "  }\n}\n");
+  fclose(json);
+  Print(4095, "results written to autotune.json\n");
 }
@@ -30,6 +30,9 @@
 #  include <sys/types.h>
 #  include <sys/stat.h>
 #endif
+#if defined(PEXT)
+#  include <immintrin.h>
+#endif
 #include <stdint.h>
 #include <inttypes.h>
 #include <time.h>
@@ -77,12 +80,15 @@
 #  define MAXPLY                                 129
 #  define MAX_TC_NODES                       3000000
 #  define MAX_BLOCKS                       64 * CPUS
+#  define INPUT_RING_SIZE                    65536
+#  define REP_FILTER_SIZE                     1024
 #  define BOOK_CLUSTER_SIZE                     8000
 #  define MERGE_BLOCK                           1000
 #  define SORT_BLOCK                         4000000
 #  define LEARN_INTERVAL                          10
 #  define LEARN_COUNTER_BAD                      -80
 #  define LEARN_COUNTER_GOOD                    +100
+#  define LEARN_POSITIONS_MAGIC  0x43524146544c504eull
 #  define MATE                                 32768
 #  define TBWIN                                31000
 #  define PAWN_VALUE                             100
@@ -190,6 +196,10 @@ typedef struct {
   unsigned status;
   int bm_age;
   PATH path;
+  uint64_t nodes;
+  int time;
+  int score;
+  int bound;
 } ROOT_MOVE;
 #  if !defined(UNIX)
 #    pragma pack(4)
@@ -207,6 +217,18 @@ typedef struct {
   unsigned char status;
   unsigned char percent_play;
 } BB_POSITION;
+typedef struct {
+  int record;
+  int correct;
+  int depth;
+  int value;
+  int wtm;
+  unsigned time;
+  uint64_t nodes;
+  char title[72];
+  char solution[96];
+  char best[16];
+} TEST_RESULT;
 struct personality_term {
   char *description;
   int type;
@@ -232,9 +254,13 @@ typedef struct tree {
   uint64_t save_hash_key[MAXPLY + 3];
   uint64_t save_pawn_hash_key[MAXPLY + 3];
   uint64_t rep_list[256];
+  uint8_t rep_filter[REP_FILTER_SIZE];
+  int rep_top;
   int curmv[MAXPLY];
   int phase[MAXPLY];
   int hash_move[MAXPLY];
+  uint64_t see_attacks[MAXPLY];
+  int see_target[MAXPLY];
   unsigned *last[MAXPLY];
   unsigned move_list[5120];
   PATH pv[MAXPLY];
@@ -249,8 +275,12 @@ typedef struct tree {
   uint64_t fail_highs;
   uint64_t fail_high_first_move;
   uint64_t evaluations;
+  uint64_t eval_cache_hits;
   uint64_t egtb_probes;
   uint64_t egtb_hits;
+  uint64_t egtb_cache_hits;
+  uint64_t egtb_probe_time;
+  uint64_t egtb_probe_times[8];
   uint64_t extensions_done;
   uint64_t qchecks_done;
   uint64_t moves_fpruned;
@@ -260,6 +290,7 @@ typedef struct tree {
 /* thread stuff */
   lock_t lock;
   int thread_id;
+  int block_id;
   volatile int joinable;
   volatile int joined;
   volatile int stop;
@@ -284,7 +315,9 @@ typedef struct thread {
   uint64_t max_blocks;
   unsigned int idle;
   volatile unsigned int terminate;
-  char filler[40];
+  uint64_t lock_waits;
+  uint64_t lock_cycles;
+  char filler[24];
 } THREAD;
 /*
    DO NOT modify these.  these are constants, used in multiple modules.
@@ -328,6 +361,7 @@ void AlignedMalloc(void **, uint64_t, size_t);
 void AlignedRemalloc(void **, uint64_t, size_t);
 void Analyze(void);
 void Annotate(void);
+void AnnotateCopyGame(FILE *, char *, int);
 void AnnotateHeaderHTML(char *, FILE *);
 void AnnotateFooterHTML(FILE *);
 void AnnotatePositionHTML(TREE *RESTRICT, int, FILE *);
@@ -342,6 +376,7 @@ uint64_t AttacksFrom(TREE *RESTRICT, int, int);
 uint64_t AttacksTo(TREE *RESTRICT, int);
 void AutoTune(int, char **);
 int Bench(int, int);
+int BenchSMP(int, int, char *);
 int Book(TREE *RESTRICT, int);
 void BookClusterIn(FILE *, int, BOOK_POSITION *);
 void BookClusterOut(FILE *, int, BOOK_POSITION *);
@@ -427,6 +462,7 @@ void InitializePawnMasks(void);
 void InitializeLMP(void);
 void InitializeLMR(void);
 void InitializeSMP(void);
+void InitializeWorker(int);
 int IInitializeTb(char *);
 int InputMove(TREE *RESTRICT, int, int, int, int, char *);
 int InputMoveICS(TREE *RESTRICT, int, int, int, int, char *);
@@ -442,6 +478,12 @@ int LearnAdjust(int);
 void LearnBook(void);
 int LearnFunction(int, int, int, int);
 void LearnValue(int, int);
+void LearnPosition(TREE *RESTRICT, int, int, int);
+void LearnPositionsClose(void);
+int LearnPositionsLoad(TREE *RESTRICT, int);
+int LearnPositionsLoadOne(TREE *RESTRICT, int, int);
+int LearnPositionsOpen(char *, size_t);
+uint64_t LearnPositionsProbe(uint64_t);
 void MakeMove(TREE *RESTRICT, int, int, int);
 void MakeMoveRoot(TREE *RESTRICT, int, int);
 int Mated(TREE *RESTRICT, int, int);
@@ -463,6 +505,7 @@ void Print(int, char *, ...);
 int ProbeDTZ(TREE * RESTRICT tree, int ply, int wtm);
 int HashProbe(TREE *RESTRICT, int, int, int, int, int, int*);
 void HashStore(TREE *RESTRICT, int, int, int, int, int, int);
+void HashPV(TREE *RESTRICT, int, PATH *);
 void HashStorePV(TREE *RESTRICT, int, int);
 int Quiesce(TREE *RESTRICT, int, int, int, int, int);
 int QuiesceEvasions(TREE *RESTRICT, int, int, int, int);
@@ -472,12 +515,17 @@ int Read(int, char *);
 int ReadChessMove(TREE *RESTRICT, FILE *, int, int);
 void ReadClear(void);
 unsigned ReadClock(void);
+uint64_t ReadClockUsec(void);
 int ReadPGN(FILE *, int);
 int ReadNextMove(TREE *RESTRICT, char *, int, int);
 int ReadParse(char *, char *args[], char *);
 int ReadInput(void);
+#  if defined(UNIX) && (CPUS > 1)
+void *STDCALL ReadInputThread(void *);
+#  endif
 int Repeat(TREE *RESTRICT, int);
 int Repeat3x(TREE *RESTRICT);
+void RepeatReset(TREE *RESTRICT);
 void ResignOrDraw(TREE *RESTRICT, int);
 void RestoreGame(void);
 void RootMoveList(int);
@@ -492,10 +540,13 @@ void SharedFree(void *address);
 void SortRootMoves(TREE *RESTRICT, int);
 int Split(TREE *RESTRICT);
 int StrCnt(char *, char);
-int SEE(TREE *RESTRICT, int, int);
+int SEE(TREE *RESTRICT, int, int, int);
 int SEEO(TREE *RESTRICT, int, int);
 void Test(char *, FILE *, int, int);
 void TestEPD(char *, FILE *, int, int);
+void TestEPDParallel(char *, FILE *, int, int);
+void TestEPDResult(TEST_RESULT *, char *, FILE *, FILE *, int, int, int *,
+    int *, int *, uint64_t *, float *);
 void ThreadAffinity(int);
 void *STDCALL ThreadInit(void *);
 #  if !defined(UNIX)
@@ -555,15 +606,28 @@ extern void WinFreeInterleaved(void *, size_t);
   }
 #  define Check(side) Attacks(tree, Flip(side), KingSQ(side))
 #  define Attack(from,to) (!(intervening[from][to] & OccupiedSquares))
-#  define BishopAttacks(square, occ) *(magic_bishop_indices[square]+((((occ)&magic_bishop_mask[square])*magic_bishop[square])>>magic_bishop_shift[square]))
-#  define BishopMobility(square, occ) *(magic_bishop_mobility_indices[square]+((((occ)&magic_bishop_mask[square])*magic_bishop[square])>>magic_bishop_shift[square]))
+/*
+   the magic tables are "plain" magics, each square uses exactly
+   2^popcnt(mask) entries, so the BMI2 pext instruction produces an
+   index into the same tables without the multiply and shift.
+ */
+#  if defined(PEXT)
+#    define BishopIndex(square, occ) _pext_u64(occ, magic_bishop_mask[square])
+#    define RookIndex(square, occ) _pext_u64(occ, magic_rook_mask[square])
+#  else
+#    define BishopIndex(square, occ) ((((occ)&magic_bishop_mask[square])*magic_bishop[square])>>magic_bishop_shift[square])
+#    define RookIndex(square, occ) ((((occ)&magic_rook_mask[square])*magic_rook[square])>>magic_rook_shift[square])
+#  endif
+#  define BishopAttacks(square, occ) *(magic_bishop_indices[square]+BishopIndex(square, occ))
+#  define BishopMobility(square, occ) *(magic_bishop_mobility_indices[square]+BishopIndex(square, occ))
 #  define KingAttacks(square) king_attacks[square]
 #  define KnightAttacks(square) knight_attacks[square]
 #  define PawnAttacks(side, square)   pawn_attacks[side][square]
 #  define Reversible(p)               (tree->status[p].reversible)
+#  define RepFilter(key)              ((key) >> 54)
 #  define ReversibleMove(m)           (!CaptureOrPromote(m) && Piece(m) != pawn)
-#  define RookAttacks(square, occ) *(magic_rook_indices[square]+((((occ)&magic_rook_mask[square])*magic_rook[square])>>magic_rook_shift[square]))
-#  define RookMobility(square, occ) *(magic_rook_mobility_indices[square]+((((occ)&magic_rook_mask[square])*magic_rook[square])>>magic_rook_shift[square]))
+#  define RookAttacks(square, occ) *(magic_rook_indices[square]+RookIndex(square, occ))
+#  define RookMobility(square, occ) *(magic_rook_mobility_indices[square]+RookIndex(square, occ))
 #  define QueenAttacks(square, occ)   (BishopAttacks(square, occ)|RookAttacks(square, occ))
 #  define Rank(x)        ((x)>>3)
 #  define File(x)        ((x)&7)
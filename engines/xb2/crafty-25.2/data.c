@@ -8,6 +8,7 @@ FILE *normal_bs_file;
 FILE *computer_bs_file;
 FILE *history_file;
 FILE *log_file;
+FILE *root_log_file = 0;
 int presult = 0;
 uint64_t total_moves;
 int allow_cores = 1;
@@ -18,7 +19,16 @@ char history_filename[256];
 int number_of_solutions;
 int solutions[10];
 int solution_type;
+int test_workers = 0;
 char cmd_buffer[4096];
+#if defined(UNIX) && (CPUS > 1)
+char input_ring[INPUT_RING_SIZE];
+volatile unsigned input_head = 0, input_tail = 0;
+volatile int input_eof = 0;
+int input_thread = 0;
+pthread_mutex_t input_mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t input_ready = PTHREAD_COND_INITIALIZER;
+#endif
 char *args[512];
 char buffer[4096];
 int line_length = 80;
@@ -34,6 +44,9 @@ int book_move;
 int book_learn_eval[LEARN_INTERVAL];
 int book_learn_depth[LEARN_INTERVAL];
 int learn_positions_count = 0;
+HASH_ENTRY *learn_positions = 0;
+size_t learn_positions_size = 0;
+int learn_positions_depth = 12;
 int learn_seekto[64];
 uint64_t learn_key[64];
 int learn_nmoves[64];
@@ -43,6 +56,7 @@ uint64_t book_learn_key;
 HASH_ENTRY *hash_table;
 HPATH_ENTRY *hash_path;
 PAWN_HASH_ENTRY *pawn_hash_table;
+uint64_t *eval_hash_table;
 void * segments[MAX_BLOCKS + 32][2];
 int nsegments = 0;
 PATH last_pv;
@@ -481,8 +495,9 @@ int EGTBlimit = 0;
 int EGTB_use = 0;
 int EGTB_draw = 0;
 int EGTB_depth = 0;
-size_t EGTB_cache_size = 4096 * 4096;
-void *EGTB_cache = (void *) 0;
+size_t EGTB_cache_size = 65536;
+uint64_t EGTB_cache_mask = 65535;
+uint64_t *EGTB_cache = (uint64_t *) 0;
 int EGTB_setup = 0;
 #endif
 int xboard = 0;
@@ -508,6 +523,7 @@ int LMR_max= 15;                      /* maximum reduction 15 plies           */
 double LMR_db = 1.8;                  /* depth is 1.8x as important as        */
 double LMR_mb = 1.0;                  /* moves searched in the formula.       */
 double LMR_s = 2.0;                   /* smaller numbers increase reductions. */
+int lazy_eval_scale = 100;            /* lazy eval margins, percent of normal */
 uint8_t LMR[32][64];
 int rep_index;
 int search_depth = 0;
@@ -519,6 +535,7 @@ int time_used = 0;
 int time_used_opponent = 0;
 int analyze_mode = 0;
 int annotate_mode = 0;
+int annotate_workers = 0;
 int input_status = 0;
 int resign = 9;
 int resign_counter = 0;
@@ -611,6 +628,8 @@ unsigned parallel_splits;
 unsigned parallel_splits_wasted;
 unsigned parallel_aborts;
 unsigned parallel_joins;
+volatile uint64_t smp_joinable[CPUS + 1];
+int smp_join_map = 1;
 unsigned busy_percent = 0;
 uint64_t game_max_blocks = 0;
 volatile int smp_split = 0;
@@ -675,6 +694,9 @@ size_t hash_path_size = 1ull << 16;
 uint64_t hash_path_mask = ((1ull << 16) - 1) & ~15;
 size_t pawn_hash_table_size = 1ull << 18;
 uint64_t pawn_hash_mask = (1ull << 18) - 1;
+size_t eval_hash_table_size = 0;
+uint64_t eval_hash_mask = 0;
+uint64_t eval_cache_age = 0;
 uint64_t mask_clear_entry = 0xff9ffffffffe0000ull;
 int abs_draw_score = 0;
 int accept_draws = 1;
@@ -1058,6 +1080,7 @@ struct personality_term personality_packet[256] = {
   {"LMR formula moves searched bias         ", 3, 0, &LMR_mb},
   {"LMR scale factor                        ", 3, 0, &LMR_s},
   {"search options (continued)              ", 0, 0, NULL},        /* 10 */
+  {"lazy eval margin scale (percent)        ", 1, 0, &lazy_eval_scale},
   {NULL, 0, 0, NULL},
 };
 /* *INDENT-ON* */
@@ -29,6 +29,7 @@ extern FILE *normal_bs_file;
 extern FILE *computer_bs_file;
 extern FILE *history_file;
 extern FILE *log_file;
+extern FILE *root_log_file;
 extern int log_id;
 extern int output_format;
 #if defined(SYZYGY)
@@ -36,6 +37,9 @@ extern int EGTBlimit;
 extern int EGTB_use;
 extern int EGTB_draw;
 extern int EGTB_depth;
+extern size_t EGTB_cache_size;
+extern uint64_t EGTB_cache_mask;
+extern uint64_t *EGTB_cache;
 extern int EGTB_setup;
 #endif
 extern int last_mate_score;
@@ -43,6 +47,7 @@ extern int last_opponent_move;
 extern int check_depth;
 extern int null_depth;
 extern int null_divisor;
+extern int lazy_eval_scale;
 extern int LMR_rdepth;
 extern int LMR_min;
 extern int LMR_max;
@@ -66,6 +71,7 @@ extern char history_filename[256];
 extern int number_of_solutions;
 extern int solutions[10];
 extern int solution_type;
+extern int test_workers;
 extern int abs_draw_score;
 extern int accept_draws;
 extern int offer_draws;
@@ -84,6 +90,14 @@ extern char log_path[128];
 extern char tb_path[128];
 extern char rc_path[128];
 extern char cmd_buffer[4096];
+#if defined(UNIX) && (CPUS > 1)
+extern char input_ring[INPUT_RING_SIZE];
+extern volatile unsigned input_head, input_tail;
+extern volatile int input_eof;
+extern int input_thread;
+extern pthread_mutex_t input_mutex;
+extern pthread_cond_t input_ready;
+#endif
 extern char *args[512];
 extern char buffer[4096];
 extern int line_length;
@@ -104,6 +118,7 @@ extern int ponder_value;
 extern int move_actually_played;
 extern int analyze_mode;
 extern int annotate_mode;
+extern int annotate_workers;
 extern int input_status;        /* 0=no input;
                                    1=predicted move read;
                                    2=unpredicted move read;
@@ -186,6 +201,8 @@ extern unsigned parallel_splits;
 extern unsigned parallel_splits_wasted;
 extern unsigned parallel_aborts;
 extern unsigned parallel_joins;
+extern volatile uint64_t smp_joinable[CPUS + 1];
+extern int smp_join_map;
 extern unsigned busy_percent;
 extern uint64_t game_max_blocks;
 extern volatile int smp_split;
@@ -229,6 +246,9 @@ extern uint64_t learn_key[64];
 extern int learn_nmoves[64];
 extern uint64_t book_learn_key;
 extern int learn_positions_count;
+extern HASH_ENTRY *learn_positions;
+extern size_t learn_positions_size;
+extern int learn_positions_depth;
 extern int book_learn_nmoves;
 extern int book_learn_seekto;
 extern int usage_level;
@@ -239,9 +259,13 @@ extern uint64_t mask_clear_entry;
 extern uint64_t hash_path_mask;
 extern size_t pawn_hash_table_size;
 extern uint64_t pawn_hash_mask;
+extern size_t eval_hash_table_size;
+extern uint64_t eval_hash_mask;
+extern uint64_t eval_cache_age;
 extern HASH_ENTRY *hash_table;
 extern HPATH_ENTRY *hash_path;
 extern PAWN_HASH_ENTRY *pawn_hash_table;
+extern uint64_t *eval_hash_table;
 extern void *segments[MAX_BLOCKS + 32][2];
 extern int nsegments;
 extern const int pcval[7];
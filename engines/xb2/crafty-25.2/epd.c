@@ -214,14 +214,60 @@ nonstatic charptrT EPDStringAppendStr(charptrT s0, charptrT s1) {
   return ptr;
 }
 
+/*--> EPDArenaGrab: allocate memory from an arena */
+static voidptrT EPDArenaGrab(arnptrT * arnptrptr, liT n) {
+  arnptrT arnptr;
+  voidptrT ptr;
+  liT size;
+
+/* keep each allocation 16 byte aligned */
+  n = (n + 15) & ~15;
+/* start a new block if the current one is full */
+  arnptr = *arnptrptr;
+  if ((arnptr == NULL) || ((arnptr->arn_used + n) > arnptr->arn_size)) {
+    size = (n > arnblockL) ? n : arnblockL;
+    arnptr = (arnptrT) EPDMemoryGrab(arnhdrL + size);
+    arnptr->arn_size = size;
+    arnptr->arn_used = 0;
+    arnptr->arn_next = *arnptrptr;
+    *arnptrptr = arnptr;
+  };
+  ptr = (voidptrT) ((charptrT) arnptr + arnhdrL + arnptr->arn_used);
+  arnptr->arn_used += n;
+  return ptr;
+}
+
+/*--> EPDArenaStringGrab: allocate and copy a string in an arena */
+static charptrT EPDArenaStringGrab(arnptrT * arnptrptr, charptrT s) {
+  charptrT ptr;
+
+  ptr = (charptrT) EPDArenaGrab(arnptrptr, strlen(s) + 1);
+  strcpy(ptr, s);
+  return ptr;
+}
+
+/*--> EPDArenaRelease: release all of the memory in an arena */
+static
+void EPDArenaRelease(arnptrT * arnptrptr) {
+  arnptrT arnptr;
+
+  while (*arnptrptr != NULL) {
+    arnptr = *arnptrptr;
+    *arnptrptr = arnptr->arn_next;
+    EPDMemoryFree(arnptr);
+  };
+  return;
+}
+
 /*--> EPDNewGPM: allocate and initialize a new GPM record */
-static gpmptrT EPDNewGPM(mptrT mptr) {
+static gpmptrT EPDNewGPM(gamptrT gamptr, mptrT mptr) {
   gpmptrT gpmptr;
   cT c;
   sqT sq;
   cpT cp0, cp1;
 
-  gpmptr = (gpmptrT) EPDMemoryGrab(sizeof(gpmT));
+/* played move records live in the game's arena */
+  gpmptr = (gpmptrT) EPDArenaGrab(&gamptr->gam_arnptr, sizeof(gpmT));
   gpmptr->gpm_m = *mptr;
   gpmptr->gpm_ese.ese_actc = ese.ese_actc;
   gpmptr->gpm_ese.ese_cast = ese.ese_cast;
@@ -239,14 +285,6 @@ static gpmptrT EPDNewGPM(mptrT mptr) {
   return gpmptr;
 }
 
-/*--> EPDReleaseGPM: release a GPM record */
-static
-void EPDReleaseGPM(gpmptrT gpmptr) {
-  if (gpmptr != NULL)
-    EPDMemoryFree(gpmptr);
-  return;
-}
-
 /*--> EPDAppendGPM: append a GPM record to a game  */
 static
 void EPDAppendGPM(gamptrT gamptr, gpmptrT gpmptr) {
@@ -260,30 +298,11 @@ void EPDAppendGPM(gamptrT gamptr, gpmptrT gpmptr) {
   return;
 }
 
-/*--> EPDUnthreadGPM: unthread a GPM record from a game */
-static
-void EPDUnthreadGPM(gamptrT gamptr, gpmptrT gpmptr) {
-  if (gpmptr->gpm_prev == NULL)
-    gamptr->gam_headgpm = gpmptr->gpm_next;
-  else
-    gpmptr->gpm_prev->gpm_next = gpmptr->gpm_next;
-  if (gpmptr->gpm_next == NULL)
-    gamptr->gam_tailgpm = gpmptr->gpm_prev;
-  else
-    gpmptr->gpm_next->gpm_prev = gpmptr->gpm_prev;
-  return;
-}
-
 /*--> EPDReleaseGPMoveChain: release the game played moves chain */
 static
 void EPDReleaseGPMoveChain(gamptrT gamptr) {
-  gpmptrT gpmptr;
-
-  while (gamptr->gam_headgpm != NULL) {
-    gpmptr = gamptr->gam_tailgpm;
-    EPDUnthreadGPM(gamptr, gpmptr);
-    EPDReleaseGPM(gpmptr);
-  };
+/* the records themselves are released with the game's arena */
+  gamptr->gam_headgpm = gamptr->gam_tailgpm = NULL;
   return;
 }
 
@@ -293,8 +312,10 @@ static gamptrT EPDNewGAM(void) {
   pgnstrT pgnstr;
 
   gamptr = (gamptrT) EPDMemoryGrab(sizeof(gamT));
+  gamptr->gam_arnptr = NULL;
   for (pgnstr = 0; pgnstr < pgnstrL; pgnstr++)
-    gamptr->gam_strv[pgnstr] = EPDStringGrab("");
+    gamptr->gam_strv[pgnstr] =
+        EPDArenaStringGrab(&gamptr->gam_arnptr, "");
   gamptr->gam_gtim = gtim_u;
   gamptr->gam_headgpm = gamptr->gam_tailgpm = NULL;
   gamptr->gam_prev = gamptr->gam_next = NULL;
@@ -308,9 +329,9 @@ void EPDReleaseGAM(gamptrT gamptr) {
 
   if (gamptr != NULL) {
     for (pgnstr = 0; pgnstr < pgnstrL; pgnstr++)
-      if (gamptr->gam_strv[pgnstr] != NULL)
-        EPDMemoryFree(gamptr->gam_strv[pgnstr]);
+      gamptr->gam_strv[pgnstr] = NULL;
     EPDReleaseGPMoveChain(gamptr);
+    EPDArenaRelease(&gamptr->gam_arnptr);
     EPDMemoryFree(gamptr);
   };
   return;
@@ -392,17 +413,20 @@ nonstatic void EPDGameClose(gamptrT gamptr) {
 nonstatic void EPDGameAppendMove(gamptrT gamptr, mptrT mptr) {
   gpmptrT gpmptr;
 
-  gpmptr = EPDNewGPM(mptr);
+  gpmptr = EPDNewGPM(gamptr, mptr);
   EPDAppendGPM(gamptr, gpmptr);
   return;
 }
 
 /*--> EPDNewTKN: allocate and initialize a new TKN record */
-static tknptrT EPDNewTKN(charptrT s) {
+static tknptrT EPDNewTKN(charptrT s, liT length) {
   tknptrT tknptr;
 
-  tknptr = (tknptrT) EPDMemoryGrab(sizeof(tknT));
-  tknptr->tkn_str = EPDStringGrab(s);
+/* the record and its string share a single allocation */
+  tknptr = (tknptrT) EPDMemoryGrab(sizeof(tknT) + length + 1);
+  tknptr->tkn_str = (charptrT) (tknptr + 1);
+  memcpy(tknptr->tkn_str, s, length);
+  *(tknptr->tkn_str + length) = ascii_nul;
   tknptr->tkn_prev = tknptr->tkn_next = NULL;
   return tknptr;
 }
@@ -410,11 +434,8 @@ static tknptrT EPDNewTKN(charptrT s) {
 /*--> EPDReleaseTKN: release a TKN record */
 static
 void EPDReleaseTKN(tknptrT tknptr) {
-  if (tknptr != NULL) {
-    if (tknptr->tkn_str != NULL)
-      EPDMemoryFree(tknptr->tkn_str);
+  if (tknptr != NULL)
     EPDMemoryFree(tknptr);
-  };
   return;
 }
 
@@ -460,10 +481,9 @@ void EPDReleaseTokenChain(void) {
 
 /*--> EPDTokenize: create the token chain */
 nonstatic void EPDTokenize(charptrT s) {
-  siT i;
+  siT i, start;
   char c;
   tknptrT tknptr;
-  charptrT str;
 
 /* first, release any existing chain */
   EPDReleaseTokenChain();
@@ -476,14 +496,11 @@ nonstatic void EPDTokenize(charptrT s) {
       c = *(s + i++);
 /* if not at end of string, then a token has started */
     if (c != ascii_nul) {
-      str = EPDStringGrab("");
-      while ((c != ascii_nul) && !isspace(c)) {
-        str = EPDStringAppendChar(str, c);
+      start = i - 1;
+      while ((c != ascii_nul) && !isspace(c))
         c = *(s + i++);
-      };
-      tknptr = EPDNewTKN(str);
+      tknptr = EPDNewTKN(s + start, i - 1 - start);
       EPDAppendTKN(tknptr);
-      EPDMemoryFree(str);
     };
   };
   return;
@@ -4079,9 +4096,8 @@ nonstatic charptrT EPDPGNGetSTR(gamptrT gamptr, pgnstrT pgnstr) {
 
 /*--> EPDPGNPutSTR: enter a string into the Seven Tag Roster */
 nonstatic void EPDPGNPutSTR(gamptrT gamptr, pgnstrT pgnstr, charptrT s) {
-  if (gamptr->gam_strv[pgnstr] != NULL)
-    EPDMemoryFree(gamptr->gam_strv[pgnstr]);
-  gamptr->gam_strv[pgnstr] = EPDStringGrab(s);
+/* the old value stays in the game's arena until the game is released */
+  gamptr->gam_strv[pgnstr] = EPDArenaStringGrab(&gamptr->gam_arnptr, s);
   return;
 }
 
@@ -610,6 +610,19 @@ typedef struct eseS {
   sqT ese_ksqv[rcL];		/* king square locations */
 } eseT, *eseptrT;
 
+/* arena block record type (bulk allocation, released all at once) */
+typedef struct arnS {
+  liT arn_size;		/* usable bytes in this block */
+  liT arn_used;		/* bytes already handed out */
+  struct arnS *arn_next;	/* next (older) block */
+} arnT, *arnptrT;
+
+/* arena block header size (keeps allocations 16 byte aligned) */
+#    define arnhdrL ((liT) ((sizeof(arnT) + 15) & ~15))
+
+/* arena default block size */
+#    define arnblockL 16384
+
 /* game played move record type (entries are prior to move) */
 typedef struct gpmS {
   mT gpm_m;			/* the move to be played */
@@ -627,6 +640,7 @@ typedef struct gamS {
   gpmptrT gam_tailgpm;		/* tail of game played move list */
   struct gamS *gam_prev;	/* previous game */
   struct gamS *gam_next;	/* next game */
+  arnptrT gam_arnptr;		/* arena for move records and tag values */
 } gamT, *gamptrT;
 
 /* statndard disply output column limit */
@@ -24,6 +24,7 @@
 /* system includes */
 #  if defined(UNIX)
 #    include <unistd.h>
+#    include <sys/resource.h>
 #  endif
 #  include <ctype.h>
 #  include <time.h>
@@ -42,34 +43,35 @@
 /* EPD glue command type */
 typedef siT egcommT, *egcommptrT;
 
-#  define egcommL 26
+#  define egcommL 27
 #  define egcomm_nil (-1)
 #  define egcomm_epdapgn  0 /* append a PGN game to a file */
 #  define egcomm_epdbfix  1 /* fix file for Bookup import */
-#  define egcomm_epdcert  2 /* display certain evaluation (if possible) */
-#  define egcomm_epdcics  3 /* slave to an Internet Chess Server */
-#  define egcomm_epdcomm  4 /* slave to the Duplex referee program */
-#  define egcomm_epddpgn  5 /* display the current game in PGN */
-#  define egcomm_epddsml  6 /* display SAN move list */
-#  define egcomm_epddstr  7 /* display PGN Seven Tag Roster */
-#  define egcomm_epddtpv  8 /* display PGN tag pair value */
-#  define egcomm_epdenum  9 /* enumerate EPD file */
-#  define egcomm_epdhelp 10 /* display EPD help */
-#  define egcomm_epdlink 11 /* slave to the Argus referee program */
-#  define egcomm_epdlpgn 12 /* load a PGN game from a file */
-#  define egcomm_epdlrec 13 /* load an EPD record form a file */
-#  define egcomm_epdmore 14 /* more help */
-#  define egcomm_epdnoop 15 /* no operation */
-#  define egcomm_epdpfdn 16 /* process file: data normalization */
-#  define egcomm_epdpfdr 17 /* process file: data repair */
-#  define egcomm_epdpfga 18 /* process file: general analysis */
-#  define egcomm_epdpflc 19 /* process file: locate cooks */
-#  define egcomm_epdpfop 20 /* process file: operation purge */
-#  define egcomm_epdscor 21 /* score EPD benchmark result file */
-#  define egcomm_epdshow 22 /* show EPD four fields for current position */
-#  define egcomm_epdspgn 23 /* save a PGN game to a file */
-#  define egcomm_epdstpv 24 /* set PGN tag pair value */
-#  define egcomm_epdtest 25 /* developer testing */
+#  define egcomm_epdbpgn  2 /* benchmark PGN load/save */
+#  define egcomm_epdcert  3 /* display certain evaluation (if possible) */
+#  define egcomm_epdcics  4 /* slave to an Internet Chess Server */
+#  define egcomm_epdcomm  5 /* slave to the Duplex referee program */
+#  define egcomm_epddpgn  6 /* display the current game in PGN */
+#  define egcomm_epddsml  7 /* display SAN move list */
+#  define egcomm_epddstr  8 /* display PGN Seven Tag Roster */
+#  define egcomm_epddtpv  9 /* display PGN tag pair value */
+#  define egcomm_epdenum 10 /* enumerate EPD file */
+#  define egcomm_epdhelp 11 /* display EPD help */
+#  define egcomm_epdlink 12 /* slave to the Argus referee program */
+#  define egcomm_epdlpgn 13 /* load a PGN game from a file */
+#  define egcomm_epdlrec 14 /* load an EPD record form a file */
+#  define egcomm_epdmore 15 /* more help */
+#  define egcomm_epdnoop 16 /* no operation */
+#  define egcomm_epdpfdn 17 /* process file: data normalization */
+#  define egcomm_epdpfdr 18 /* process file: data repair */
+#  define egcomm_epdpfga 19 /* process file: general analysis */
+#  define egcomm_epdpflc 20 /* process file: locate cooks */
+#  define egcomm_epdpfop 21 /* process file: operation purge */
+#  define egcomm_epdscor 22 /* score EPD benchmark result file */
+#  define egcomm_epdshow 23 /* show EPD four fields for current position */
+#  define egcomm_epdspgn 24 /* save a PGN game to a file */
+#  define egcomm_epdstpv 25 /* set PGN tag pair value */
+#  define egcomm_epdtest 26 /* developer testing */
 /* output text buffer */
 #  define tbufL 256
 static char tbufv[tbufL];
@@ -96,7 +98,8 @@ void EGPrint(charptrT s) {
  is provided to handle this.
  Note that there is no corresponding routine for reading from the
  standard input because the EPD glue does no interactive reading, except
- for a single getchar() call in the epdhelp display pager.
+ for the epdhelp display pager, which uses Crafty's Read() so that it
+ gets its input the same way as every other command.
  */
 /* for Crafty, the standard output is used */
   printf("%s", s);
@@ -951,6 +954,186 @@ static siT EGProcessBFIX(void) {
   return flag;
 }
 
+/*--> EGProcessBPGN: process the EG command epdbpgn */
+static siT EGProcessBPGN(void) {
+  siT flag, bad, depth, i, n;
+  fptrT fptr0, fptr1;
+  gamptrT gamptr;
+  pgnstrT pgnstr;
+  mptrT mptr;
+  mT m;
+  charptrT s, p, q;
+  liT games, skipped;
+  int start;
+  long rss;
+  char ev[epdL], fn0[tL], fn1[tL];
+
+/* this is an internal EPD glue routine */
+/*
+ This reads every game in a PGN file into EPD Kit game structures and
+ writes each one back out as PGN, reporting the rate in games per second
+ and the peak resident set size.  It goes through the same code used by
+ the other PGN commands (tokenizing, SAN decoding, the played move chain
+ and tag values of a game, and PGN generation) so it can be used to
+ measure changes to them.  Games that start from a FEN position or that
+ contain an unrecognized move are skipped.
+ */
+/* set the default return value: success */
+  flag = 1;
+/* clear the file pointers */
+  fptr0 = fptr1 = NULL;
+/* parameter count check */
+  if ((EPDTokenCount() != 2) && (EPDTokenCount() != 3)) {
+    EGPL("This command takes one or two parameters.");
+    flag = 0;
+  };
+/* copy the file names, as the token chain is reused below */
+  if (flag) {
+    strncpy(fn0, EPDTokenFetch(1), tL - 1);
+    fn0[tL - 1] = '\0';
+    fn1[0] = '\0';
+    if (EPDTokenCount() == 3) {
+      strncpy(fn1, EPDTokenFetch(2), tL - 1);
+      fn1[tL - 1] = '\0';
+    };
+    fptr0 = fopen(fn0, "r");
+    if (fptr0 == NULL)
+      flag = 0;
+  };
+  if (flag && (fn1[0] != '\0')) {
+    fptr1 = fopen(fn1, "w");
+    if (fptr1 == NULL)
+      flag = 0;
+  };
+/* process the epdbpgn command */
+  if (flag) {
+    gamptr = NULL;
+    bad = depth = 0;
+    games = skipped = 0;
+    start = ReadClock();
+    while (fgets(ev, (epdL - 1), fptr0) != NULL) {
+/* tag pair: open a new game if needed, then record the value */
+      if ((ev[0] == '[') && (depth == 0)) {
+        if (gamptr == NULL) {
+          gamptr = EPDGameOpen();
+          EPDReset();
+          bad = 0;
+        };
+        p = ev + 1;
+        q = strchr(p, '"');
+        if (q == NULL)
+          continue;
+        s = q;
+        while ((s > p) && isspace(*(s - 1)))
+          s--;
+        *s = '\0';
+        s = strrchr(++q, '"');
+        if (s != NULL)
+          *s = '\0';
+        if ((strcmp(p, "FEN") == 0) || (strcmp(p, "SetUp") == 0))
+          bad = 1;
+        pgnstr = EPDPGNFetchTagIndex(p);
+        if (pgnstr != pgnstr_nil)
+          EPDPGNPutSTR(gamptr, pgnstr, q);
+        continue;
+      };
+/* movetext: tokenize the line and handle each token */
+      EPDTokenize(ev);
+      n = EPDTokenCount();
+      for (i = 0; i < n; i++) {
+        s = EPDTokenFetch(i);
+/* comments and variations (depth counts open braces/parentheses) */
+        if ((depth > 0) || (*s == '{') || (*s == '(')) {
+          for (p = s; *p != '\0'; p++)
+            if ((*p == '{') || (*p == '('))
+              depth++;
+            else if (((*p == '}') || (*p == ')')) && (depth > 0))
+              depth--;
+          continue;
+        };
+        if (*s == ';')
+          break;
+        if (*s == '$')
+          continue;
+/* game termination marker: write out the game */
+        if ((strcmp(s, "1-0") == 0) || (strcmp(s, "0-1") == 0) ||
+            (strcmp(s, "1/2-1/2") == 0) || (strcmp(s, "*") == 0)) {
+          if (gamptr != NULL) {
+            if (!bad) {
+              if (strcmp(s, "1-0") == 0)
+                EPDPutGTIM(gamptr, gtim_w);
+              else if (strcmp(s, "0-1") == 0)
+                EPDPutGTIM(gamptr, gtim_b);
+              else if (strcmp(s, "1/2-1/2") == 0)
+                EPDPutGTIM(gamptr, gtim_d);
+              p = EPDPGNHistory(gamptr);
+              if (fptr1 != NULL)
+                fprintf(fptr1, "%s\n", p);
+              EPDMemoryFree(p);
+              games++;
+            } else
+              skipped++;
+            EPDGameClose(gamptr);
+            gamptr = NULL;
+          };
+          continue;
+        };
+/* strip any move number prefix */
+        p = s;
+        while (isdigit(*p))
+          p++;
+        while (*p == '.')
+          p++;
+        if (*p == '\0')
+          continue;
+/* a move: open a game if there were no tags */
+        if (gamptr == NULL) {
+          gamptr = EPDGameOpen();
+          EPDReset();
+          bad = 0;
+        };
+        if (bad)
+          continue;
+        EPDGenMoves();
+        mptr = EPDSANDecodeAux(p, 0);
+        if (mptr == NULL)
+          bad = 1;
+        else {
+          m = *mptr;
+          EPDGameAppendMove(gamptr, &m);
+          EPDExecuteUpdate(&m);
+          EPDCollapse();
+        };
+      };
+    };
+/* an unterminated game at the end of the file is discarded */
+    if (gamptr != NULL)
+      EPDGameClose(gamptr);
+    start = ReadClock() - start;
+    rss = 0;
+#  if defined(UNIX)
+    {
+      struct rusage ru;
+
+      getrusage(RUSAGE_SELF, &ru);
+      rss = ru.ru_maxrss;
+    }
+#  endif
+    sprintf(tbufv, "games: %ld  skipped: %ld  time: %.2f seconds\n", games,
+        skipped, (double) start / 100);
+    EGPrintTB();
+    sprintf(tbufv, "games/second: %.0f  peak RSS: %ld KB\n",
+        (double) games * 100 / Max(start, 1), rss);
+    EGPrintTB();
+  };
+/* ensure file close */
+  if (fptr0 != NULL)
+    fclose(fptr0);
+  if (fptr1 != NULL)
+    fclose(fptr1);
+  return flag;
+}
+
 /*--> EGProcessCICS: process the EG command epdcics */
 static siT EGProcessCICS(void) {
   siT flag;
@@ -1194,7 +1377,7 @@ static siT EGProcessHELP(void) {
 /* process the epdhelp command */
   if (flag) {
 /* it is not clear exactly why the next statment is needed */
-    getchar();
+    Read(1, buffer);
 /* list all the commands */
     egcomm = 0;
     while (egcomm < egcommL) {
@@ -1210,7 +1393,7 @@ static siT EGProcessHELP(void) {
       if (egcomm < egcommL) {
         EGPL("");
         EGPL("Press <return> for more command help");
-        getchar();
+        Read(1, buffer);
         EGPL("");
       };
     };
@@ -1337,6 +1520,16 @@ static siT EGProcessMORE(void) {
         EGPL("pv operations.  This second file can then be imported into");
         EGPL("the Bookup program.");
         break;
+      case egcomm_epdbpgn:
+        EGPL("epdbpgn: Benchmark PGN load/save");
+        EGPL("");
+        EGPL("This command reads every game in a PGN file into the EPD");
+        EGPL("Kit game structures and writes each one back out as PGN.");
+        EGPL("It then displays the number of games processed, the games");
+        EGPL("per second rate, and the peak resident set size.  The first");
+        EGPL("parameter is the PGN file to read and the optional second");
+        EGPL("parameter is a file for the PGN output.");
+        break;
       case egcomm_epdcert:
         EGPL("epdcert: Try to display a certain evaluation");
         EGPL("");
@@ -2194,6 +2387,9 @@ nonstatic int EGCommand(char *s) {
       case egcomm_epdbfix:
         flag = EGProcessBFIX();
         break;
+      case egcomm_epdbpgn:
+        flag = EGProcessBPGN();
+        break;
       case egcomm_epdcics:
         flag = EGProcessCICS();
         break;
@@ -2283,6 +2479,7 @@ nonstatic void EGInit(void) {
 /* initialize the EPD glue command strings vector */
   egcommstrv[egcomm_epdapgn] = "epdapgn";
   egcommstrv[egcomm_epdbfix] = "epdbfix";
+  egcommstrv[egcomm_epdbpgn] = "epdbpgn";
   egcommstrv[egcomm_epdcert] = "epdcert";
   egcommstrv[egcomm_epdcics] = "epdcics";
   egcommstrv[egcomm_epdcomm] = "epdcomm";
@@ -2310,6 +2507,7 @@ nonstatic void EGInit(void) {
 /* initialize the EPD glue command string descriptions vector */
   eghelpstrv[egcomm_epdapgn] = "Append PGN game to <file>";
   eghelpstrv[egcomm_epdbfix] = "Fix <file1> data for Bookup input <file2>";
+  eghelpstrv[egcomm_epdbpgn] = "Benchmark PGN load/save of <file1> [<file2>]";
   eghelpstrv[egcomm_epdcert] =
       "Display certain score for the current position";
   eghelpstrv[egcomm_epdcics] = "Slave to ICS at <hostname> and <portnumber>";
@@ -1,7 +1,7 @@
 #include "chess.h"
 #include "evaluate.h"
 #include "data.h"
-/* last modified 08/03/16 */
+/* last modified 10/19/26 */
 /*
  *******************************************************************************
  *                                                                             *
@@ -19,7 +19,8 @@
 int Evaluate(TREE * RESTRICT tree, int ply, int wtm, int alpha, int beta) {
   PAWN_HASH_ENTRY *ptable;
   PXOR *pxtable;
-  int score, side, can_win = 3, phase, lscore, cutoff;
+  uint64_t *etable = 0, etag = 0;
+  int score, side, can_win = 3, phase, lscore, cutoff, full = 0;
 
 /*
  *************************************************************
@@ -55,11 +56,46 @@ int Evaluate(TREE * RESTRICT tree, int ply, int wtm, int alpha, int beta) {
  */
   cutoff = (TotalPieces(white, occupied) && TotalPieces(black, occupied))
       ? KNIGHT_VALUE : ROOK_VALUE;
+  cutoff = cutoff * lazy_eval_scale / 100;
   lscore = MaterialSTM(wtm);
   if (lscore + cutoff < alpha)
     return alpha;
   if (lscore - cutoff > beta)
     return beta;
+/*
+ *************************************************************
+ *                                                           *
+ *  Probe the evaluation cache.  Quiescence search evaluates *
+ *  the same positions over and over, so we remember the     *
+ *  last full evaluation for each signature.  Each entry is  *
+ *  a single 64 bit word, the upper 48 bits of the tag and   *
+ *  the score (white's point of view) in the lower 16 bits,  *
+ *  so the table needs no locks.  The tag is HashKey (side   *
+ *  to move included) mixed with eval_cache_age, which is    *
+ *  bumped at the start of each search since castling and    *
+ *  draw scores are evaluated relative to the root.  We do   *
+ *  not use the cache when the 50 move counter is high since *
+ *  that term is not part of the hash signature.             *
+ *                                                           *
+ *************************************************************
+ */
+  if (eval_hash_table_size && Reversible(ply) <= 80) {
+#if defined(SKILL)
+    if (skill >= 100) {
+#endif
+      etag =
+          ((wtm) ? HashKey : ~HashKey) ^ (eval_cache_age *
+          0x9e3779b97f4a7c15ull);
+      etable = eval_hash_table + (etag & eval_hash_mask);
+      if ((*etable ^ etag) >> 16 == 0) {
+        tree->eval_cache_hits++;
+        score = (int16_t) * etable;
+        return (wtm) ? score : -score;
+      }
+#if defined(SKILL)
+    }
+#endif
+  }
 /*
  *************************************************************
  *                                                           *
@@ -256,6 +292,7 @@ int Evaluate(TREE * RESTRICT tree, int ply, int wtm, int alpha, int beta) {
   cutoff = 72 + (w_mat + b_mat) * 8 + abs(w_mat - b_mat) * 16;
   if (tree->dangerous[white] || tree->dangerous[black])
     cutoff += 35;
+  cutoff = cutoff * lazy_eval_scale / 100;
 /*
  *************************************************************
  *                                                           *
@@ -288,6 +325,7 @@ int Evaluate(TREE * RESTRICT tree, int ply, int wtm, int alpha, int beta) {
         EvaluateQueens(tree, side);
     for (side = black; side <= white; side++)
       EvaluateKing(tree, ply, side);
+    full = 1;
   }
 /*
  *************************************************************
@@ -303,6 +341,8 @@ int Evaluate(TREE * RESTRICT tree, int ply, int wtm, int alpha, int beta) {
  */
   score = ((tree->score_mg * phase) + (tree->score_eg * (62 - phase))) / 62;
   score = EvaluateDraws(tree, ply, can_win, score);
+  if (etable && full && abs(score) < 32000)
+    *etable = (etag & ~0xffffull) | (uint16_t) score;
 #if defined(SKILL)
   if (skill < 100)
     score =
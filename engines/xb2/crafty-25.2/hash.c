@@ -152,7 +152,7 @@ int HashProbe(TREE * RESTRICT tree, int ply, int depth, int side, int alpha,
             }
             SavePV(tree, ply, 1);
             ptable = hash_path + (temp_hashkey & hash_path_mask);
-            for (entry = 0; entry < 16; entry++)
+            for (entry = 0; hash_path_size && entry < 16; entry++)
               if (ptable[entry].path_sig == temp_hashkey) {
                 for (i = ply;
                     i < Min(MAXPLY - 1, ptable[entry].hash_pathl + ply); i++)
@@ -338,7 +338,7 @@ void HashStore(TREE * RESTRICT tree, int ply, int depth, int side, int type,
  *                                                          *
  ************************************************************
  */
-  if (type == EXACT) {
+  if (type == EXACT && hash_path_size) {
     ptable = hash_path + (temp_hashkey & hash_path_mask);
     for (i = 0; i < 16; i++, ptable++) {
       if (ptable->path_sig == temp_hashkey ||
@@ -354,6 +354,94 @@ void HashStore(TREE * RESTRICT tree, int ply, int depth, int side, int type,
   }
 }
 
+/* last modified 10/19/26 */
+/*
+ *******************************************************************************
+ *                                                                             *
+ *   HashPV() is used to complete a PV that ended with an EXACT hash hit when  *
+ *   the path hash table has been disabled (phash=0).  Rather than recovering  *
+ *   the stored path, we make the PV moves and then simply follow the best     *
+ *   move stored in the transposition table for each successive position,      *
+ *   stopping when there is no entry, the move is not legal, or the position   *
+ *   repeats.  The PV returned is not guaranteed to be the one that produced   *
+ *   the score (entries can be overwritten) but it is normally identical, and  *
+ *   it costs nothing during the search itself.                                *
+ *                                                                             *
+ *******************************************************************************
+ */
+void HashPV(TREE * RESTRICT tree, int wtm, PATH * pv) {
+  HASH_ENTRY *htable;
+  uint64_t temp_hashkey, keys[MAXPLY];
+  int side = wtm, ply, last, entry, move, i;
+
+/*
+ ************************************************************
+ *                                                          *
+ *  First, make the PV moves we already have, remembering   *
+ *  the hash signature of each position along the way so   *
+ *  that we can stop if the hash moves lead to a cycle.     *
+ *                                                          *
+ ************************************************************
+ */
+  last = pv->pathl;
+  for (ply = 1; ply < last; ply++) {
+    keys[ply] = HashKey;
+    MakeMove(tree, ply, side, pv->path[ply]);
+    side = Flip(side);
+  }
+/*
+ ************************************************************
+ *                                                          *
+ *  Now extend the path one move at a time, using the best  *
+ *  move from the matching transposition table entry.  Any  *
+ *  move that fails ValidMove() or leaves our king in check *
+ *  (a hash collision) ends the walk.                       *
+ *                                                          *
+ ************************************************************
+ */
+  for (; ply < MAXPLY - 1; ply++) {
+    keys[ply] = HashKey;
+    for (i = ply - 2; i > 0; i -= 2)
+      if (keys[i] == keys[ply])
+        break;
+    if (i > 0)
+      break;
+    temp_hashkey = (side) ? HashKey : ~HashKey;
+    htable = hash_table + (temp_hashkey & hash_mask);
+    move = 0;
+    for (entry = 0; entry < 4; entry++)
+      if ((htable[entry].word2 ^ htable[entry].word1) == temp_hashkey) {
+        move = (htable[entry].word1 >> 32) & 0x1fffff;
+        break;
+      }
+    if (!move || !ValidMove(tree, ply, side, move))
+      break;
+    MakeMove(tree, ply, side, move);
+    if (Check(side)) {
+      UnmakeMove(tree, ply, side, move);
+      break;
+    }
+    pv->path[ply] = move;
+    side = Flip(side);
+  }
+  if (ply > last) {
+    pv->pathl = ply;
+    pv->pathh = 0;
+  }
+/*
+ ************************************************************
+ *                                                          *
+ *  Finally, unmake everything to restore the root position *
+ *  that we started with.                                   *
+ *                                                          *
+ ************************************************************
+ */
+  for (ply--; ply > 0; ply--) {
+    side = Flip(side);
+    UnmakeMove(tree, ply, side, pv->path[ply]);
+  }
+}
+
 /* last modified 09/16/14 */
 /*
  *******************************************************************************
@@ -96,6 +96,8 @@ void Initialize() {
       sizeof(HPATH_ENTRY) * hash_path_size);
   AlignedMalloc((void *) &pawn_hash_table, 64,
       sizeof(PAWN_HASH_ENTRY) * pawn_hash_table_size);
+  AlignedMalloc((void *) &eval_hash_table, 64,
+      sizeof(uint64_t) * eval_hash_table_size);
   if (!hash_table) {
     Print(2048,
         "AlignedMalloc() failed, not enough memory (primary trans/ref table).\n");
@@ -108,6 +110,13 @@ void Initialize() {
     pawn_hash_table_size = 0;
     pawn_hash_table = 0;
   }
+  if (!eval_hash_table) {
+    Print(2048,
+        "AlignedMalloc() failed, not enough memory (eval hash table).\n");
+    eval_hash_table_size = 0;
+    eval_hash_mask = 0;
+    eval_hash_table = 0;
+  }
 /*
  ************************************************************
  *                                                          *
@@ -426,16 +435,14 @@ void InitializeMagic(void) {
       uint64_t tempoccupied =
           InitializeMagicOccupied(squares, numsquares, temp);
       moves = InitializeMagicBishop(i, tempoccupied);
-      *(magic_bishop_indices[i] +
-          (tempoccupied * magic_bishop[i] >> magic_bishop_shift[i])) = moves;
+      *(magic_bishop_indices[i] + BishopIndex(i, tempoccupied)) = moves;
       moves |= SetMask(i);
       m = -lower_b;
       for (j = 0; j < 4; j++)
         m += PopCnt(moves & mobility_mask_b[j]) * mobility_score_b[j];
       if (m < 0)
         m *= 2;
-      *(magic_bishop_mobility_indices[i] +
-          (tempoccupied * magic_bishop[i] >> magic_bishop_shift[i])) = m;
+      *(magic_bishop_mobility_indices[i] + BishopIndex(i, tempoccupied)) = m;
     }
   }
 /*
@@ -458,14 +465,12 @@ void InitializeMagic(void) {
       uint64_t tempoccupied =
           InitializeMagicOccupied(squares, numsquares, temp);
       uint64_t moves = InitializeMagicRook(i, tempoccupied);
-      *(magic_rook_indices[i] +
-          (tempoccupied * magic_rook[i] >> magic_rook_shift[i])) = moves;
+      *(magic_rook_indices[i] + RookIndex(i, tempoccupied)) = moves;
       moves |= SetMask(i);
       m = -1;
       for (j = 0; j < 4; j++)
         m += PopCnt(moves & mobility_mask_r[j]) * mobility_score_r[j];
-      *(magic_rook_mobility_indices[i] +
-          (tempoccupied * magic_rook[i] >> magic_rook_shift[i])) =
+      *(magic_rook_mobility_indices[i] + RookIndex(i, tempoccupied)) =
           mob_curve_r[m];
     }
   }
@@ -1179,3 +1184,44 @@ void InitializeSMP(void) {
   pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
 #endif
 }
+#if defined(UNIX)
+
+/* last modified 10/19/26 */
+/*
+ *******************************************************************************
+ *                                                                             *
+ *   InitializeWorker() is called in a child process created with fork() by    *
+ *   the batch commands (test, annotate) that run several independent serial   *
+ *   searches at once.  The parent owns the terminal and the log file, so all  *
+ *   output here is discarded and input is never checked.  The parallel       *
+ *   search is disabled (fork() does not copy the helper threads anyway) and   *
+ *   each hash table is cut to the first 1/Nth of its size so that all of the  *
+ *   workers together touch no more memory than the configured table sizes.    *
+ *                                                                             *
+ *******************************************************************************
+ */
+void InitializeWorker(int workers) {
+  int shift;
+
+  if (!freopen("/dev/null", "w", stdout))
+    _exit(1);
+  log_file = 0;
+  history_file = 0;
+  batch_mode = 1;
+  smp_max_threads = 0;
+  smp_threads = 0;
+  for (shift = 0; (1 << shift) < workers; shift++);
+  if (hash_table_size >> shift >= 64) {
+    hash_table_size >>= shift;
+    hash_mask = (hash_table_size - 1) & ~3;
+  }
+  if (hash_path_size >> shift >= 64) {
+    hash_path_size >>= shift;
+    hash_path_mask = (hash_path_size - 1) & ~15;
+  }
+  if (pawn_hash_table_size >> shift >= 64) {
+    pawn_hash_table_size >>= shift;
+    pawn_hash_mask = pawn_hash_table_size - 1;
+  }
+}
+#endif
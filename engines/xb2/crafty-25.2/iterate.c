@@ -47,6 +47,7 @@ int Iterate(int wtm, int search_type, int root_list_done) {
   int i, alpha, beta, current_rm = 0, force_print = 0;
   int value = 0, twtm, correct, correct_count, npc, cpl, max;
   unsigned int idle_time;
+  uint64_t lock_waits, lock_cycles;
   char buff[32];
 #if (CPUS > 1) && defined(UNIX)
   pthread_t pt;
@@ -91,15 +92,24 @@ int Iterate(int wtm, int search_type, int root_list_done) {
     thread[i].tree = 0;
     thread[i].idle = 0;
     thread[i].terminate = 0;
+    thread[i].lock_waits = 0;
+    thread[i].lock_cycles = 0;
   }
   thread[0].tree = block[0];
   correct_count = 0;
   burp = 15 * 100;
   transposition_age = (transposition_age + 1) & 0x1ff;
+  eval_cache_age++;
   next_time_check = nodes_between_time_checks;
   tree->evaluations = 0;
+  tree->eval_cache_hits = 0;
+  RepeatReset(tree);
   tree->egtb_probes = 0;
   tree->egtb_hits = 0;
+  tree->egtb_cache_hits = 0;
+  tree->egtb_probe_time = 0;
+  for (i = 0; i < 8; i++)
+    tree->egtb_probe_times[i] = 0;
   tree->extensions_done = 0;
   tree->qchecks_done = 0;
   tree->moves_fpruned = 0;
@@ -178,6 +188,8 @@ int Iterate(int wtm, int search_type, int root_list_done) {
  *                                                          *
  ************************************************************
  */
+      if (learn_positions)
+        LearnPositionsLoad(tree, wtm);
       TimeSet(search_type);
       iteration = 1;
       noise_block = 0;
@@ -221,13 +233,17 @@ int Iterate(int wtm, int search_type, int root_list_done) {
  *  for thread 0 since it could have changed since we       *
  *  initialized everything.                                 *
  *                                                          *
+ *  Threads left running by an earlier search with fewer    *
+ *  threads are already initialized, so they count toward   *
+ *  initialized_threads or we would wait for them forever.  *
+ *                                                          *
  ************************************************************
  */
 #if (CPUS > 1)
       if (smp_max_threads > smp_threads + 1) {
         long proc;
 
-        initialized_threads = 1;
+        initialized_threads = smp_threads + 1;
         Print(32, "starting thread");
         for (proc = smp_threads + 1; proc < smp_max_threads; proc++) {
           Print(32, " %d", proc);
@@ -336,6 +352,9 @@ int Iterate(int wtm, int search_type, int root_list_done) {
           if (i || iteration == 1)
             root_moves[i].path.pathv = -MATE;
           root_moves[i].status &= 4;
+          root_moves[i].nodes = 0;
+          root_moves[i].time = 0;
+          root_moves[i].bound = 0;
         }
         while (1) {
           if (smp_max_threads > 1)
@@ -506,6 +525,33 @@ int Iterate(int wtm, int search_type, int root_list_done) {
                 (root_moves[i].status & 1) != 0);
           }
         }
+/*
+ ************************************************************
+ *                                                          *
+ *  If a "rootlog" file is open, write one line per root    *
+ *  move giving the nodes, time (seconds) and score (from   *
+ *  the side on move's perspective, with "<" or ">" when it *
+ *  is only an upper or lower bound) for this iteration.    *
+ *  This shows where the search spent its effort.           *
+ *                                                          *
+ ************************************************************
+ */
+        if (root_log_file) {
+          for (i = 0; i < n_root_moves; i++) {
+            fprintf(root_log_file, "%d,%s,%d,%s,%" PRIu64 ",%.2f,",
+                move_number, (wtm) ? "w" : "b", iteration,
+                OutputMove(tree, 1, wtm, root_moves[i].move),
+                root_moves[i].nodes, (double) root_moves[i].time / 100);
+            if (root_moves[i].bound)
+              fprintf(root_log_file, "%s%d\n",
+                  (root_moves[i].bound == UPPER) ? "<" :
+                  (root_moves[i].bound == LOWER) ? ">" : "",
+                  root_moves[i].score);
+            else
+              fprintf(root_log_file, "\n");
+          }
+          fflush(root_log_file);
+        }
 /*
  ************************************************************
  *                                                          *
@@ -521,6 +567,8 @@ int Iterate(int wtm, int search_type, int root_list_done) {
         else
           nodes_per_second = 1000000;
         tree->pv[0] = root_moves[0].path;
+        if (!hash_path_size && tree->pv[0].pathh == 1)
+          HashPV(tree, wtm, &tree->pv[0]);
         if (!abort_search && value != -(MATE - 1)) {
           if (end_time - start_time >= noise_level) {
             DisplayPV(tree, 5, wtm, end_time - start_time, &tree->pv[0],
@@ -618,7 +666,35 @@ int Iterate(int wtm, int search_type, int root_list_done) {
             (ReversibleMove(last_pv.path[1]) ? Reversible(0) + 1 : 0));
         if (tree->egtb_hits)
           Print(8, "  egtb=%s", DisplayKMB(tree->egtb_hits, 0));
+        if (eval_hash_table_size)
+          Print(8, "  ecache=%d%%",
+              (int) (tree->eval_cache_hits * 100 / (tree->eval_cache_hits +
+                      tree->evaluations)));
         Print(8, "\n");
+        if (tree->egtb_probes) {
+          static const char *tb_bucket[8] =
+              { "<4us", "<16us", "<64us", "<256us", "<1ms", "<4ms", "<16ms",
+            ">16ms"
+          };
+          uint64_t tb_reads = tree->egtb_probes - tree->egtb_cache_hits;
+
+          Print(8, "        egtb probes=%s", DisplayKMB(tree->egtb_probes,
+                  0));
+          Print(8, "  cached=%d%%",
+              (int) (tree->egtb_cache_hits * 100 / tree->egtb_probes));
+          if (tb_reads)
+            Print(8, "  avg=%dus",
+                (int) (tree->egtb_probe_time / tb_reads));
+          Print(8, "\n");
+          if (tb_reads) {
+            Print(8, "        egtb probe time:");
+            for (i = 0; i < 8; i++)
+              if (tree->egtb_probe_times[i])
+                Print(8, "  %s/%s", tb_bucket[i],
+                    DisplayKMB(tree->egtb_probe_times[i], 0));
+            Print(8, "\n");
+          }
+        }
         Print(8, "        LMReductions:");
         npc = 21;
         cpl = 75;
@@ -662,8 +738,32 @@ int Iterate(int wtm, int search_type, int root_list_done) {
           Print(8, "  joins=%s", DisplayKMB(parallel_joins, 0));
           Print(8, "  data=%d%%(%d%%)\n", 100 * max / 64,
               100 * PopCnt(game_max_blocks) / 64);
+          lock_waits = 0;
+          lock_cycles = 0;
+          for (i = 0; i < smp_max_threads; i++) {
+            lock_waits += thread[i].lock_waits;
+            lock_cycles += thread[i].lock_cycles;
+          }
+          Print(8, "        lock waits=%s", DisplayKMB(lock_waits, 0));
+          Print(8, "  cycles=%s", DisplayKMB(lock_cycles, 0));
+          if (lock_waits)
+            Print(8, "(%d/wait)", (int) (lock_cycles / lock_waits));
+          Print(8, "  join=%s\n", (smp_join_map) ? "map" : "scan");
         }
       }
+/*
+ ************************************************************
+ *                                                          *
+ *  If a shared position learning file is in use, record    *
+ *  the result of this search there so that other Crafty    *
+ *  processes (and later searches here) can use it.         *
+ *                                                          *
+ ************************************************************
+ */
+      if (learn_positions && !puzzling && !booking &&
+          tree->pv[0].pathd >= learn_positions_depth &&
+          Abs(last_root_value) < 32000)
+        LearnPosition(tree, wtm, last_root_value, tree->pv[0].pathd);
     } while (0);
 /*
  ************************************************************
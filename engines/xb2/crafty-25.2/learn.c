@@ -4,6 +4,9 @@
 #include "data.h"
 #if defined(UNIX)
 #  include <unistd.h>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
 #endif
 
 /* last modified 02/24/14 */
@@ -322,3 +325,212 @@ void LearnValue(int search_value, int search_depth) {
         crafty_rating - opponent_rating, learn_value < 0);
   }
 }
+
+/* last modified 10/19/26 */
+/*
+ *******************************************************************************
+ *                                                                             *
+ *   LearnPositionsOpen() maps the shared position learning file into memory.  *
+ *   The file is a table of HASH_ENTRY-style pairs of 64 bit words, where the  *
+ *   first pair is a header (a magic number and the number of entries) and     *
+ *   the rest are stored in buckets of four like the transposition table.      *
+ *   Each entry holds the result of a completed search (score, depth and the   *
+ *   number of times it has been stored) in word1, and word2 is the signature  *
+ *   xor'ed with word1, the same lockless trick used in the hash table.  Any   *
+ *   number of Crafty processes can map the same file with MAP_SHARED, so an   *
+ *   entry stored by one is seen by all of the others on their next search,    *
+ *   with no file locking at all.  A torn entry (one word from each of two     *
+ *   writers) simply fails the signature test and is ignored.                  *
+ *                                                                             *
+ *   The file is created with <size> bytes if it does not exist, otherwise we  *
+ *   use whatever size it was created with.                                    *
+ *                                                                             *
+ *******************************************************************************
+ */
+int LearnPositionsOpen(char *filename, size_t size) {
+#if defined(UNIX)
+  struct stat st;
+  HASH_ENTRY *map;
+  size_t entries;
+  int fd;
+
+  LearnPositionsClose();
+  fd = open(filename, O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    Print(4095, "ERROR unable to open position learning file %s\n", filename);
+    return 0;
+  }
+  fstat(fd, &st);
+  if (st.st_size == 0) {
+    entries = 1ull << MSB(Max(size / sizeof(HASH_ENTRY), 64));
+    if (ftruncate(fd, (entries + 1) * sizeof(HASH_ENTRY))) {
+      Print(4095, "ERROR unable to size position learning file %s\n",
+          filename);
+      close(fd);
+      return 0;
+    }
+  } else
+    entries = st.st_size / sizeof(HASH_ENTRY) - 1;
+  map =
+      (HASH_ENTRY *) mmap(0, (entries + 1) * sizeof(HASH_ENTRY),
+      PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    Print(4095, "ERROR unable to map position learning file %s\n", filename);
+    return 0;
+  }
+  if (map[0].word1 == 0) {
+    map[0].word2 = entries;
+    map[0].word1 = LEARN_POSITIONS_MAGIC;
+  }
+  if (map[0].word1 != LEARN_POSITIONS_MAGIC || map[0].word2 != entries ||
+      (entries & (entries - 1))) {
+    Print(4095, "ERROR %s is not a position learning file\n", filename);
+    munmap(map, (entries + 1) * sizeof(HASH_ENTRY));
+    return 0;
+  }
+  learn_positions = map;
+  learn_positions_size = entries;
+  return 1;
+#else
+  Print(4095, "position learning file requires a Unix system\n");
+  return 0;
+#endif
+}
+
+/* last modified 10/19/26 */
+/*
+ *******************************************************************************
+ *                                                                             *
+ *   LearnPositionsClose() unmaps the position learning file, if one is open.  *
+ *                                                                             *
+ *******************************************************************************
+ */
+void LearnPositionsClose(void) {
+#if defined(UNIX)
+  if (learn_positions)
+    munmap(learn_positions, (learn_positions_size + 1) * sizeof(HASH_ENTRY));
+#endif
+  learn_positions = 0;
+  learn_positions_size = 0;
+}
+
+/* last modified 10/19/26 */
+/*
+ *******************************************************************************
+ *                                                                             *
+ *   LearnPositionsProbe() looks up <key> in the position learning file.  If   *
+ *   found, it returns the raw data word (see LearnPosition()), else zero.     *
+ *                                                                             *
+ *******************************************************************************
+ */
+uint64_t LearnPositionsProbe(uint64_t key) {
+  HASH_ENTRY *bucket;
+  uint64_t word1, word2;
+  int entry;
+
+  bucket = learn_positions + 1 + (key & (learn_positions_size - 1) & ~3);
+  for (entry = 0; entry < 4; entry++) {
+    word1 = bucket[entry].word1;
+    word2 = bucket[entry].word2;
+    if (word1 && (word1 ^ word2) == key)
+      return word1;
+  }
+  return 0;
+}
+
+/* last modified 10/19/26 */
+/*
+ *******************************************************************************
+ *                                                                             *
+ *   LearnPosition() stores the result of a completed search of the root       *
+ *   position in the position learning file.  word1 is laid out as follows:    *
+ *                                                                             *
+ *     bits  0-31  score (from the side on move's perspective)                 *
+ *     bits 32-39  search depth                                                *
+ *     bits 40-63  number of times this position has been stored               *
+ *                                                                             *
+ *   We overwrite an entry with the same signature, or else the entry in the   *
+ *   bucket with the shallowest depth.  Two processes can race here, but the   *
+ *   worst that can happen is that one of the two results is lost.             *
+ *                                                                             *
+ *******************************************************************************
+ */
+void LearnPosition(TREE * RESTRICT tree, int wtm, int value, int depth) {
+  HASH_ENTRY *bucket, *replace = 0;
+  uint64_t key = (wtm) ? HashKey : ~HashKey, word1, count = 0;
+  int entry, replace_depth = 256;
+
+  bucket = learn_positions + 1 + (key & (learn_positions_size - 1) & ~3);
+  for (entry = 0; entry < 4; entry++) {
+    word1 = bucket[entry].word1;
+    if (word1 && (word1 ^ bucket[entry].word2) == key) {
+      replace = bucket + entry;
+      count = word1 >> 40;
+      break;
+    }
+    if ((int) ((word1 >> 32) & 255) < replace_depth) {
+      replace = bucket + entry;
+      replace_depth = (word1 >> 32) & 255;
+    }
+  }
+  word1 =
+      ((count + 1) << 40) | ((uint64_t) Min(depth, 255) << 32) | (uint32_t)
+      value;
+  replace->word1 = word1;
+  replace->word2 = word1 ^ key;
+}
+
+/* last modified 10/19/26 */
+/*
+ *******************************************************************************
+ *                                                                             *
+ *   LearnPositionsLoad() is called by Iterate() before a search starts.  It   *
+ *   looks up every position one and two plies from the root in the position   *
+ *   learning file and stuffs any it finds into the transposition table as     *
+ *   EXACT entries, so that the search will use what this (or any other)       *
+ *   Crafty process learned about those positions until it searches them       *
+ *   deeper itself.  We only need to look two plies deep since the positions   *
+ *   stored are always root positions, which is where they tend to show up     *
+ *   again.                                                                    *
+ *                                                                             *
+ *******************************************************************************
+ */
+int LearnPositionsLoad(TREE * RESTRICT tree, int wtm) {
+  unsigned replies[256], *last, *mv;
+  int i, loaded = 0;
+
+  for (i = 0; i < n_root_moves; i++) {
+    MakeMove(tree, 1, wtm, root_moves[i].move);
+    loaded += LearnPositionsLoadOne(tree, 2, Flip(wtm));
+    last = GenerateCaptures(tree, 2, Flip(wtm), replies);
+    last = GenerateNoncaptures(tree, 2, Flip(wtm), last);
+    for (mv = replies; mv < last; mv++) {
+      MakeMove(tree, 2, Flip(wtm), *mv);
+      loaded += LearnPositionsLoadOne(tree, 3, wtm);
+      UnmakeMove(tree, 2, Flip(wtm), *mv);
+    }
+    UnmakeMove(tree, 1, wtm, root_moves[i].move);
+  }
+  return loaded;
+}
+
+/* last modified 10/19/26 */
+/*
+ *******************************************************************************
+ *                                                                             *
+ *   LearnPositionsLoadOne() stores the learned result for the position at     *
+ *   <ply> in the transposition table, if there is one.                        *
+ *                                                                             *
+ *******************************************************************************
+ */
+int LearnPositionsLoadOne(TREE * RESTRICT tree, int ply, int side) {
+  uint64_t word1 = LearnPositionsProbe((side) ? HashKey : ~HashKey);
+
+  if (!word1)
+    return 0;
+  tree->pv[ply - 1].pathl = ply;
+  HashStore(tree, ply, (word1 >> 32) & 255, side, EXACT,
+      (int) (int32_t) word1, 0);
+  return 1;
+}
@@ -15,11 +15,19 @@
 extern pthread_t NumaStartThread(void *func, void *args);
 
 #    include <windows.h>
+#    include <intrin.h>
 typedef volatile LONG lock_t[1];
 
 #    define LockInit(v)      ((v)[0] = 0)
 #    define LockFree(v)      ((v)[0] = 0)
 #    define Unlock(v)        ((v)[0] = 0)
+#    define LockTimed(v, t)  {if ((v)[0]) {uint64_t c = __rdtsc(); Lock(v);  \
+                               (t).lock_cycles += __rdtsc() - c;          \
+                               (t).lock_waits++;} else Lock(v);}
+#    define AtomicSet(a, b)   (_InterlockedOr64((volatile LONG64 *) &(b),   \
+                                (LONG64) 1 << (a)))
+#    define AtomicClear(a, b) (_InterlockedAnd64((volatile LONG64 *) &(b),  \
+                                ~((LONG64) 1 << (a))))
 __forceinline void Lock(volatile LONG * hPtr) {
   int iValue;
 
@@ -69,18 +77,33 @@ static void __inline__ UnlockX86(volatile int *lock) {
       :"q"(lock)
       :"memory");
 }
+static uint64_t __inline__ ReadCycles() {
+  unsigned lo, hi;
+  asm __volatile__(
+      "            rdtsc"                   "\n\t"
+      :"=a"(lo), "=d"(hi));
+  return ((uint64_t) hi << 32) | lo;
+}
 
 #    define LockInit(p)           (p=0)
 #    define LockFree(p)           (p=0)
 #    define Unlock(p)             (UnlockX86(&p))
 #    define Lock(p)               (LockX86(&p))
+#    define LockTimed(p, t)       {if (p) {uint64_t c = ReadCycles(); Lock(p); \
+                                    (t).lock_cycles += ReadCycles() - c;     \
+                                    (t).lock_waits++;} else Lock(p);}
+#    define AtomicSet(a, b)       (__sync_fetch_and_or(&(b), 1ull << (a)))
+#    define AtomicClear(a, b)     (__sync_fetch_and_and(&(b), ~(1ull << (a))))
 #    define lock_t                volatile int
 #  endif
 #else
 #  define LockInit(p)
 #  define LockFree(p)
 #  define Lock(p)
+#  define LockTimed(p, t)
 #  define Unlock(p)
+#  define AtomicSet(a, b)       Set(a, b)
+#  define AtomicClear(a, b)     Clear(a, b)
 #  define lock_t                volatile int
 #endif /*  SMP code */
 /* *INDENT-ON* */
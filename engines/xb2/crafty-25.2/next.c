@@ -74,6 +74,7 @@ int NextMove(TREE * RESTRICT tree, int ply, int depth, int side, int in_check) {
  */
     case GENERATE_CAPTURES:
       tree->next_status[ply].phase = CAPTURES;
+      tree->see_target[ply] = -1;
       if (!in_check)
         tree->last[ply] =
             GenerateCaptures(tree, ply, side, tree->last[ply - 1]);
@@ -126,7 +127,7 @@ int NextMove(TREE * RESTRICT tree, int ply, int depth, int side, int in_check) {
           tree->next_status[ply].phase = KILLER1;
         if (pcval[Piece(tree->curmv[ply])] <=
             pcval[Captured(tree->curmv[ply])]
-            || SEE(tree, side, tree->curmv[ply]) >= 0) {
+            || SEE(tree, ply, side, tree->curmv[ply]) >= 0) {
           *(tree->next_status[ply].last - 1) = 0;
           tree->phase[ply] = CAPTURES;
           return ++tree->next_status[ply].order;
@@ -544,7 +545,8 @@ int NextRootMoveParallel(void) {
   for (which = 0; which < n_root_moves; which++)
     if (!(root_moves[which].status & 8))
       break;
-  if (which < n_root_moves && !(root_moves[which].status & 4))
+  if (which < n_root_moves && (!(root_moves[which].status & 4) ||
+          smp_split_at_root > 1))
     return 1;
   return 0;
 }
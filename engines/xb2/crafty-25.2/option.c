@@ -191,6 +191,33 @@ int Option(TREE * RESTRICT tree) {
       return 2;
     Annotate();
   }
+/*
+ ************************************************************
+ *                                                          *
+ *  "annotatemt" sets the number of worker processes the    *
+ *  annotate commands use.  Each worker annotates different *
+ *  games from the input file with a serial search.  0 (the *
+ *  default) annotates one game at a time.                  *
+ *                                                          *
+ ************************************************************
+ */
+  else if (OptionMatch("annotatemt", *args)) {
+    if (nargs < 2) {
+      printf("usage:  annotatemt=<workers>\n");
+      return 1;
+    }
+    if (thinking || pondering)
+      return 2;
+    annotate_workers = Max(0, atoi(args[1]));
+#if !defined(UNIX)
+    Print(4095, "WARNING - parallel annotation requires a Unix system.\n");
+#endif
+    if (annotate_workers > 1)
+      Print(32, "annotate will use %d worker processes.\n",
+          annotate_workers);
+    else
+      Print(32, "annotate will process one game at a time.\n");
+  }
 /*
  ************************************************************
  *                                                          *
@@ -240,14 +267,27 @@ int Option(TREE * RESTRICT tree) {
  *  by one ply, and "bench -1" reduces the depth to speed   *
  *  it up.                                                  *
  *                                                          *
+ *  "bench smp <n> [file] [mod]" runs the benchmark with 1, *
+ *  2, 4, ... n threads and displays the speedup for each   *
+ *  thread count.  If [file] is given, the results for each *
+ *  position are written to it as CSV (or as JSON if the    *
+ *  file name ends in ".json").                             *
+ *                                                          *
  ************************************************************
  */
   else if (OptionMatch("bench", *args)) {
     int mod = 0;
 
-    if (nargs > 1)
-      mod = atoi(args[1]);
-    (void) Bench(mod, 0);
+    if (nargs > 2 && !strcmp(args[1], "smp")) {
+      nargs = ReadParse(buffer, args, " \t;=");
+      if (nargs > 4)
+        mod = atoi(args[4]);
+      (void) BenchSMP(mod, atoi(args[2]), (nargs > 3) ? args[3] : 0);
+    } else {
+      if (nargs > 1)
+        mod = atoi(args[1]);
+      (void) Bench(mod, 0);
+    }
   }
 /*
  ************************************************************
@@ -541,6 +581,50 @@ int Option(TREE * RESTRICT tree) {
     strcpy(buffer, "savepos *");
     Option(tree);
   }
+/*
+ ************************************************************
+ *                                                          *
+ *  "ehash" command sets the size of the evaluation cache.  *
+ *  The size can be entered in bytes, K bytes, M bytes or G *
+ *  bytes as with the "hash" command.  Each entry is 8      *
+ *  bytes, and the number of entries is rounded down to a   *
+ *  perfect power of 2.  ehash=0 disables the cache, which  *
+ *  is the default.                                         *
+ *                                                          *
+ ************************************************************
+ */
+  else if (OptionMatch("ehash", *args)) {
+    size_t new_hash_size;
+
+    if (thinking || pondering)
+      return 2;
+    if (nargs > 1) {
+      new_hash_size = atoiKMB(args[1]);
+      if (new_hash_size && new_hash_size < 16 * 1024) {
+        printf("ERROR.  Minimum eval hash table size is 16K bytes.\n");
+        return 1;
+      }
+      if (new_hash_size) {
+        eval_hash_table_size =
+            1ull << MSB(new_hash_size / sizeof(uint64_t));
+        AlignedRemalloc((void *) &eval_hash_table, 64,
+            sizeof(uint64_t) * eval_hash_table_size);
+        if (!eval_hash_table) {
+          printf("AlignedRemalloc() failed, not enough memory.\n");
+          exit(1);
+        }
+        eval_hash_mask = eval_hash_table_size - 1;
+        memset((void *) eval_hash_table, 0,
+            eval_hash_table_size * sizeof(uint64_t));
+      } else {
+        eval_hash_table_size = 0;
+        eval_hash_mask = 0;
+      }
+    }
+    Print(32, "eval hash table memory = %s bytes",
+        DisplayKMB(eval_hash_table_size * sizeof(uint64_t), 1));
+    Print(32, " (%s entries).\n", DisplayKMB(eval_hash_table_size, 1));
+  }
 /*
  ************************************************************
  *                                                          *
@@ -557,6 +641,15 @@ int Option(TREE * RESTRICT tree) {
         tb_init(tb_path);
         EGTB_setup = 1;
       }
+      if (!EGTB_cache) {
+        AlignedMalloc((void *) &EGTB_cache, 64,
+            EGTB_cache_size * sizeof(uint64_t));
+        if (!EGTB_cache) {
+          printf("AlignedMalloc() failed, not enough memory.\n");
+          exit(1);
+        }
+        memset((void *) EGTB_cache, 0, EGTB_cache_size * sizeof(uint64_t));
+      }
       EGTBlimit = TB_LARGEST;
     }
     if (EGTBlimit)
@@ -568,6 +661,48 @@ int Option(TREE * RESTRICT tree) {
     Print(32, "SYZYGY support not included (no -DSYZYGY)\n");
 #endif
   }
+/*
+ ************************************************************
+ *                                                          *
+ *  "egtbcache" command sets the size of the cache of EGTB  *
+ *  WDL probe results.  The size can be entered in bytes,   *
+ *  K bytes, M bytes or G bytes as with the "hash" command. *
+ *  Each entry is 8 bytes, and the number of entries is     *
+ *  rounded down to a perfect power of 2.                   *
+ *                                                          *
+ ************************************************************
+ */
+  else if (OptionMatch("egtbcache", *args)) {
+#if defined(SYZYGY)
+    size_t new_cache_size;
+
+    if (thinking || pondering)
+      return 2;
+    if (nargs > 1) {
+      new_cache_size = atoiKMB(args[1]);
+      if (new_cache_size < 64 * 1024) {
+        printf("ERROR.  Minimum egtbcache size is 64K bytes.\n");
+        return 1;
+      }
+      EGTB_cache_size = ((1ull) << MSB(new_cache_size / sizeof(uint64_t)));
+      EGTB_cache_mask = EGTB_cache_size - 1;
+      if (EGTB_cache) {
+        AlignedRemalloc((void *) &EGTB_cache, 64,
+            EGTB_cache_size * sizeof(uint64_t));
+        if (!EGTB_cache) {
+          printf("AlignedRemalloc() failed, not enough memory.\n");
+          exit(1);
+        }
+        memset((void *) EGTB_cache, 0, EGTB_cache_size * sizeof(uint64_t));
+      }
+    }
+    Print(32, "egtb cache memory = %s bytes",
+        DisplayKMB(EGTB_cache_size * sizeof(uint64_t), 1));
+    Print(32, " (%s entries).\n", DisplayKMB(EGTB_cache_size, 1));
+#else
+    Print(32, "SYZYGY support not included (no -DSYZYGY)\n");
+#endif
+  }
 /*
  ************************************************************
  *                                                          *
@@ -904,6 +1039,11 @@ int Option(TREE * RESTRICT tree) {
  *  have a perfect power of 2 entries.  The value entered   *
  *  will be rounded down to meet that requirement.          *
  *                                                          *
+ *  phash=0 disables the path hash table completely.  PVs   *
+ *  that end in an EXACT hash hit are then completed by     *
+ *  following the best moves stored in the normal trans/ref *
+ *  table instead (see HashPV()).                           *
+ *                                                          *
  ************************************************************
  */
   else if (OptionMatch("phash", *args)) {
@@ -913,23 +1053,31 @@ int Option(TREE * RESTRICT tree) {
       return 2;
     if (nargs > 1) {
       new_hash_size = atoiKMB(args[1]);
-      if (new_hash_size < 64 * 1024) {
+      if (new_hash_size && new_hash_size < 64 * 1024) {
         printf("ERROR.  Minimum phash table size is 64K bytes.\n");
         return 1;
       }
-      hash_path_size = ((1ull) << MSB(new_hash_size / sizeof(HPATH_ENTRY)));
+      if (new_hash_size)
+        hash_path_size =
+            ((1ull) << MSB(new_hash_size / sizeof(HPATH_ENTRY)));
+      else
+        hash_path_size = 0;
       AlignedRemalloc((void *) &hash_path, 64,
-          sizeof(HPATH_ENTRY) * hash_path_size);
+          sizeof(HPATH_ENTRY) * Max(hash_path_size, 16));
       if (!hash_path) {
         printf("AlignedRemalloc() failed, not enough memory.\n");
         hash_path_size = 0;
         hash_path = 0;
       }
-      hash_path_mask = (hash_path_size - 1) & ~15;
+      hash_path_mask = (hash_path_size) ? (hash_path_size - 1) & ~15 : 0;
     }
-    Print(32, "hash path table memory = %s bytes",
-        DisplayKMB(hash_path_size * sizeof(HPATH_ENTRY), 1));
-    Print(32, " (%s entries).\n", DisplayKMB(hash_path_size, 1));
+    if (hash_path_size) {
+      Print(32, "hash path table memory = %s bytes",
+          DisplayKMB(hash_path_size * sizeof(HPATH_ENTRY), 1));
+      Print(32, " (%s entries).\n", DisplayKMB(hash_path_size, 1));
+    } else
+      Print(32, "hash path table disabled, PVs completed from trans/ref"
+          " table.\n");
     InitializeHashTables(old_hash_size != hash_path_size);
   }
 /*
@@ -1164,6 +1312,46 @@ int Option(TREE * RESTRICT tree) {
       }
     }
   }
+/*
+ ************************************************************
+ *                                                          *
+ *  "learnpos" command controls the shared position         *
+ *  learning file (see LearnPositionsOpen() in learn.c).    *
+ *                                                          *
+ *    learnpos <file> [size]  maps <file>, creating it with *
+ *                            <size> bytes (default 1M) if  *
+ *                            it does not exist.            *
+ *    learnpos depth <n>      only store searches that      *
+ *                            reached at least <n> plies.   *
+ *    learnpos off            stops using the file.         *
+ *                                                          *
+ *  With no arguments, it displays the current status.      *
+ *                                                          *
+ ************************************************************
+ */
+  else if (OptionMatch("learnpos", *args)) {
+    size_t i, used = 0;
+
+    if (thinking || pondering)
+      return 2;
+    nargs = ReadParse(buffer, args, " \t;=");
+    if (nargs > 2 && !strcmp(args[1], "depth"))
+      learn_positions_depth = atoi(args[2]);
+    else if (nargs > 1 && !strcmp(args[1], "off"))
+      LearnPositionsClose();
+    else if (nargs > 1)
+      LearnPositionsOpen(args[1], (nargs > 2) ? atoiKMB(args[2]) : 1 << 20);
+    if (learn_positions) {
+      for (i = 1; i <= learn_positions_size; i++)
+        if (learn_positions[i].word1)
+          used++;
+      Print(32, "position learning file: %s entries, ",
+          DisplayKMB(learn_positions_size, 1));
+      Print(32, "%s used, min depth %d\n", DisplayKMB(used, 1),
+          learn_positions_depth);
+    } else
+      Print(32, "position learning file not in use\n");
+  }
 /*
  ************************************************************
  *                                                          *
@@ -2162,13 +2350,16 @@ int Option(TREE * RESTRICT tree) {
 /*
  ************************************************************
  *                                                          *
- *  "perf" command turns times move generator/make_move.    *
+ *  "perf" command times move generator/make_move/Repeat(). *
  *                                                          *
  ************************************************************
  */
 #define PERF_CYCLES 4000000
   else if (OptionMatch("perf", *args)) {
-    int i, clock_before, clock_after;
+    int i, ply, reps = 0, save_rep_index = rep_index, clock_before,
+        clock_after;
+    uint64_t keys[100], save_key = HashKey, save_list[256];
+    SEARCH_POSITION save_status[MAXPLY + 3];
     unsigned *mv;
     float time_used;
 
@@ -2208,6 +2399,44 @@ int Option(TREE * RESTRICT tree) {
     printf("generated/made/unmade %d moves per second\n",
         (int) (((float) (PERF_CYCLES * (tree->last[1] -
                         tree->last[0]))) / time_used));
+/*
+ ************************************************************
+ *                                                          *
+ *  Finally time Repeat() walking down a long sequence of   *
+ *  reversible moves (no repetitions, 98 plies deep, as in  *
+ *  a shuffling endgame near the 50 move limit) over and    *
+ *  over, then restore the real repetition list.            *
+ *                                                          *
+ ************************************************************
+ */
+    memcpy(save_status, tree->status, sizeof(tree->status));
+    memcpy(save_list, tree->rep_list, sizeof(tree->rep_list));
+    rep_index = 0;
+    for (ply = 0; ply < 100; ply++) {
+      keys[ply] = Random64();
+      tree->rep_list[ply] = keys[ply];
+      Reversible(ply) = ply;
+    }
+    RepeatReset(tree);
+    clock_before = clock();
+    while (clock() == clock_before);
+    clock_before = clock();
+    for (i = 0; i < PERF_CYCLES / 10; i++)
+      for (ply = 2; ply < 100; ply++) {
+        HashKey = keys[ply];
+        reps += Repeat(tree, ply);
+      }
+    clock_after = clock();
+    time_used =
+        ((float) clock_after - (float) clock_before) / (float) CLOCKS_PER_SEC;
+    printf("repetition checks %d (%d draws), time=%.2f seconds\n",
+        PERF_CYCLES / 10 * 98, reps, time_used);
+    printf("repetition checks %d per second\n",
+        (int) ((float) PERF_CYCLES / 10 * 98 / time_used));
+    memcpy(tree->status, save_status, sizeof(tree->status));
+    memcpy(tree->rep_list, save_list, sizeof(tree->rep_list));
+    HashKey = save_key;
+    rep_index = save_rep_index;
   }
 /*
  ************************************************************
@@ -2674,6 +2903,39 @@ int Option(TREE * RESTRICT tree) {
     else
       Print(32, "disabled resignations.\n");
   }
+/*
+ ************************************************************
+ *                                                          *
+ *  "rootlog" command opens a file that Iterate() appends   *
+ *  one line per root move to after each iteration, giving  *
+ *  the nodes, time and score for that move, as comma-      *
+ *  separated values.  The header line is only written to   *
+ *  an empty file, so a log can be reopened and extended.   *
+ *  "rootlog off" closes it.                                *
+ *                                                          *
+ ************************************************************
+ */
+  else if (OptionMatch("rootlog", *args)) {
+    if (nargs < 2) {
+      printf("usage:  rootlog <filename>|off\n");
+      return 1;
+    }
+    nargs = ReadParse(buffer, args, " \t;=");
+    if (root_log_file)
+      fclose(root_log_file);
+    root_log_file = 0;
+    if (strcmp(args[1], "off")) {
+      root_log_file = fopen(args[1], "a");
+      if (!root_log_file)
+        Print(4095, "ERROR unable to open root log file %s\n", args[1]);
+      else {
+        fseek(root_log_file, 0, SEEK_END);
+        if (ftell(root_log_file) == 0)
+          fprintf(root_log_file,
+              "move,side,iteration,rootmove,nodes,seconds,score\n");
+      }
+    }
+  }
 /*
  ************************************************************
  *                                                          *
@@ -2960,6 +3222,7 @@ int Option(TREE * RESTRICT tree) {
     Print(32, "    comp     mg      eg   |\n");
     root_wtm = Flip(game_wtm);
     tree->status[1] = tree->status[0];
+    eval_cache_age++;
     s = Evaluate(tree, 1, game_wtm, -99999, 99999);
     trop[black] = tree->tropism[black];
     trop[white] = tree->tropism[white];
@@ -3355,7 +3618,11 @@ int Option(TREE * RESTRICT tree) {
  *   "smproot" command is used to enable (1) or disable (0) *
  *   splitting the tree at the root (ply=1).  Splitting at  *
  *   the root is more efficient, but might slow finding the *
- *   move in some test positions.                           *
+ *   move in some test positions.  2 also splits at the     *
+ *   root while moves that were recently best are still     *
+ *   left to search, which keeps all threads busy in wide   *
+ *   positions at the cost of finding a new best move a     *
+ *   little more slowly.                                    *
  *                                                          *
  *   "smpgsd" sets the minimum depth remaining at which a   *
  *   gratuitous split can be done.                          *
@@ -3364,6 +3631,11 @@ int Option(TREE * RESTRICT tree) {
  *   per thread.  This only counts splits that have not yet *
  *   been joined.                                           *
  *                                                          *
+ *   "smpjoinmap" selects how idle threads find split       *
+ *   points to join.  1 (default) uses the atomic bitmap of *
+ *   joinable split blocks, 0 scans every split block.  The *
+ *   lock wait statistics after a search compare the two.   *
+ *                                                          *
  ************************************************************
  */
   else if (OptionMatch("smpaffinity", *args)) {
@@ -3452,11 +3724,13 @@ int Option(TREE * RESTRICT tree) {
       Print(32, "SMP NUMA mode disabled.\n");
   } else if (OptionMatch("smproot", *args)) {
     if (nargs < 2) {
-      printf("usage:  smproot 0|1\n");
+      printf("usage:  smproot 0|1|2\n");
       return 1;
     }
     smp_split_at_root = atoi(args[1]);
-    if (smp_split_at_root)
+    if (smp_split_at_root > 1)
+      Print(32, "SMP search split at ply >= 1, any root move.\n");
+    else if (smp_split_at_root)
       Print(32, "SMP search split at ply >= 1.\n");
     else
       Print(32, "SMP search split at ply > 1.\n");
@@ -3475,6 +3749,16 @@ int Option(TREE * RESTRICT tree) {
     }
     smp_gratuitous_depth = atoi(args[1]);
     Print(32, "gratuitous split min depth %d.\n", smp_gratuitous_depth);
+  } else if (OptionMatch("smpjoinmap", *args)) {
+    if (nargs < 2) {
+      printf("usage:  smpjoinmap 0|1\n");
+      return 1;
+    }
+    smp_join_map = atoi(args[1]);
+    if (smp_join_map)
+      Print(32, "SMP idle threads find split points using the bitmap.\n");
+    else
+      Print(32, "SMP idle threads find split points by scanning.\n");
   }
 /*
  ************************************************************
@@ -3605,6 +3889,38 @@ int Option(TREE * RESTRICT tree) {
     if (unsolved)
       fclose(unsolved);
   }
+/*
+ ************************************************************
+ *                                                          *
+ *  "testmt" sets the number of worker processes used by    *
+ *  the "test" command for EPD suites.  Each worker solves  *
+ *  a different position using a serial search, rather than *
+ *  all threads searching one position at a time.  0 (the   *
+ *  default) runs the suite one position at a time.         *
+ *                                                          *
+ ************************************************************
+ */
+  else if (OptionMatch("testmt", *args)) {
+    if (nargs < 2) {
+      printf("usage:  testmt=<workers>\n");
+      return 1;
+    }
+    if (thinking || pondering)
+      return 2;
+    test_workers = Max(0, atoi(args[1]));
+    if (test_workers > hardware_processors) {
+      Print(4095, "WARNING - machine has %d processors.\n",
+          hardware_processors);
+    }
+#if !defined(UNIX)
+    Print(4095, "WARNING - parallel test suites require a Unix system.\n");
+#endif
+    if (test_workers > 1)
+      Print(32, "test suites will use %d worker processes.\n",
+          test_workers);
+    else
+      Print(32, "test suites will be run serially.\n");
+  }
 /*
  ************************************************************
  *                                                          *
@@ -131,6 +131,7 @@ int Quiesce(TREE * RESTRICT tree, int ply, int wtm, int alpha, int beta,
  ************************************************************
  */
   tree->last[ply] = GenerateCaptures(tree, ply, wtm, tree->last[ply - 1]);
+  tree->see_target[ply] = -1;
   for (movep = tree->last[ply - 1]; movep < tree->last[ply]; movep++) {
     if (Captured(*movep) == king)
       return beta;
@@ -174,7 +175,7 @@ int Quiesce(TREE * RESTRICT tree, int ply, int wtm, int alpha, int beta,
     if (pcval[Piece(tree->curmv[ply])] > pcval[Captured(tree->curmv[ply])] &&
         TotalPieces(Flip(wtm), occupied)
         - p_vals[Captured(tree->curmv[ply])] > 0 &&
-        SEE(tree, wtm, tree->curmv[ply]) < 0)
+        SEE(tree, ply, wtm, tree->curmv[ply]) < 0)
       continue;
 #if defined(TRACE)
     if (ply <= trace_level)
@@ -228,7 +229,7 @@ int Quiesce(TREE * RESTRICT tree, int ply, int wtm, int alpha, int beta,
  */
     for (next = tree->last[ply - 1]; next < tree->last[ply]; next++) {
       tree->curmv[ply] = Move(*next);
-      if (SEE(tree, wtm, tree->curmv[ply]) >= 0) {
+      if (SEE(tree, ply, wtm, tree->curmv[ply]) >= 0) {
 #if defined(TRACE)
         if (ply <= trace_level)
           Trace(tree, ply, 0, wtm, alpha, beta, "Quiesce+checks", serial,
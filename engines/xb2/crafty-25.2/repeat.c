@@ -1,6 +1,6 @@
 #include "chess.h"
 #include "data.h"
-/* last modified 08/03/16 */
+/* last modified 10/19/26 */
 /*
  *******************************************************************************
  *                                                                             *
@@ -29,11 +29,39 @@
  *   in a sane state for the rest of the search.  Do NOT remove those to lines *
  *   in Iterate() or repetition detection will be broken.                      *
  *                                                                             *
+ *   To avoid scanning the list at every node, each tree also keeps a small    *
+ *   filter of counters (rep_filter[]) indexed by the upper bits of the hash   *
+ *   signature, which always counts exactly the entries rep_list[0] through    *
+ *   rep_list[rep_top].  Since Repeat() is the only place that stores into the *
+ *   list during a search, it keeps the filter in sync itself.  Entries at or  *
+ *   beyond the current ply are left over from a branch we have backed out of, *
+ *   so they are removed before the current position is added (and any plies   *
+ *   that did not call Repeat() are counted as they stand).  If the            *
+ *   counter for this signature is zero, the position can not be in the list   *
+ *   and the scan is skipped.  RepeatReset() rebuilds the filter before each   *
+ *   search, and CopyFromParent() trims it for each split block.               *
+ *                                                                             *
  *******************************************************************************
  */
 int Repeat(TREE * RESTRICT tree, int ply) {
-  int where, count;
+  int where, count, current = rep_index + ply;
 
+/*
+ ************************************************************
+ *                                                          *
+ *  First bring the filter up to date with the list, which  *
+ *  means removing the entries from plies we have backed    *
+ *  out of, and then add the current position to both.      *
+ *                                                          *
+ ************************************************************
+ */
+  for (; tree->rep_top >= current; tree->rep_top--)
+    tree->rep_filter[RepFilter(tree->rep_list[tree->rep_top])]--;
+  while (tree->rep_top < current - 1)
+    tree->rep_filter[RepFilter(tree->rep_list[++tree->rep_top])]++;
+  count = tree->rep_filter[RepFilter(HashKey)]++;
+  tree->rep_list[current] = HashKey;
+  tree->rep_top = current;
 /*
  ************************************************************
  *                                                          *
@@ -41,15 +69,17 @@ int Repeat(TREE * RESTRICT tree, int ply) {
  *  score to reflect the impending draw.  If we have not    *
  *  made 2 moves for each side (or more) since the last     *
  *  irreversible move, there is no way to repeat a prior    *
- *  position.                                               *
+ *  position.  Nor can there be if the filter shows this    *
+ *  signature nowhere in the list.                          *
  *                                                          *
  ************************************************************
  */
-  tree->rep_list[rep_index + ply] = HashKey;
   if (Reversible(ply) < 4)
     return 0;
   if (Reversible(ply) > 99)
     return 3;
+  if (!count)
+    return 0;
 /*
  ************************************************************
  *                                                          *
@@ -66,7 +96,7 @@ int Repeat(TREE * RESTRICT tree, int ply) {
  ************************************************************
  */
   count = Reversible(ply) / 2 - 1;
-  for (where = rep_index + ply - 4; count; where -= 2, count--) {
+  for (where = current - 4; count; where -= 2, count--) {
     if (HashKey == tree->rep_list[where])
       return 2;
   }
@@ -114,3 +144,21 @@ int Repeat3x(TREE * RESTRICT tree) {
       reps++;
   return reps == 2;
 }
+
+/* last modified 10/19/26 */
+/*
+ *******************************************************************************
+ *                                                                             *
+ *   RepeatReset() rebuilds the repetition filter from the game history (the   *
+ *   repetition list entries 0 through rep_index) before a search starts.      *
+ *                                                                             *
+ *******************************************************************************
+ */
+void RepeatReset(TREE * RESTRICT tree) {
+  int where;
+
+  memset(tree->rep_filter, 0, sizeof(tree->rep_filter));
+  for (where = 0; where <= rep_index; where++)
+    tree->rep_filter[RepFilter(tree->rep_list[where])]++;
+  tree->rep_top = rep_index;
+}
@@ -171,20 +171,45 @@ int Search(TREE * RESTRICT tree, int ply, int depth, int wtm, int alpha,
  *  and - means behind in material, = means equal material, *
  *  and + means ahead in material.                          *
  *                                                          *
+ *  Before we actually probe, we check the EGTB cache.  It  *
+ *  is a small table shared by all threads where each entry *
+ *  is one 64 bit word, the hash signature with the WDL     *
+ *  result (+1) stored in the low 3 bits.  Since the entry  *
+ *  is a single word, it is written and read atomically and *
+ *  needs no lock.  Only positions with the 50 move counter *
+ *  at zero are probed, so the signature is enough to       *
+ *  identify the position.  A probe that misses the cache   *
+ *  is timed so that the cost of the decompression done in  *
+ *  tbcore.c shows up in the search statistics.             *
+ *                                                          *
  ************************************************************
  */
 #if defined(SYZYGY)
     if (depth > EGTB_depth && TotalAllPieces <= EGTB_use &&
         !Castle(ply, white) && !Castle(ply, black) && Reversible(ply) == 0) {
+      uint64_t tb_key = (wtm) ? HashKey : ~HashKey, tb_entry, tb_time;
       int tb_result;
 
       tree->egtb_probes++;
-      tb_result =
-          tb_probe_wdl(Occupied(white), Occupied(black),
-          Kings(white) | Kings(black), Queens(white) | Queens(black),
-          Rooks(white) | Rooks(black), Bishops(white) | Bishops(black),
-          Knights(white) | Knights(black), Pawns(white) | Pawns(black),
-          Reversible(ply), 0, EnPassant(ply), wtm, HashKey);
+      tb_entry = EGTB_cache[tb_key & EGTB_cache_mask];
+      if ((tb_entry & 7) && !((tb_entry ^ tb_key) & ~7ull)) {
+        tree->egtb_cache_hits++;
+        tb_result = (tb_entry & 7) - 1;
+      } else {
+        tb_time = ReadClockUsec();
+        tb_result =
+            tb_probe_wdl(Occupied(white), Occupied(black),
+            Kings(white) | Kings(black), Queens(white) | Queens(black),
+            Rooks(white) | Rooks(black), Bishops(white) | Bishops(black),
+            Knights(white) | Knights(black), Pawns(white) | Pawns(black),
+            Reversible(ply), 0, EnPassant(ply), wtm, HashKey);
+        tb_time = ReadClockUsec() - tb_time;
+        tree->egtb_probe_time += tb_time;
+        tree->egtb_probe_times[Min(7, MSB(tb_time | 1) / 2)]++;
+        if (tb_result != TB_RESULT_FAILED)
+          EGTB_cache[tb_key & EGTB_cache_mask] =
+              (tb_key & ~7ull) | (tb_result + 1);
+      }
       if (tb_result != TB_RESULT_FAILED) {
         tree->egtb_hits++;
         switch (tb_result) {
@@ -381,7 +406,8 @@ int SearchMoveList(TREE * RESTRICT tree, int ply, int depth, int wtm,
   TREE *current;
   int extend, reduce, check, original_alpha = alpha, t_beta;
   int i, j, value = 0, pv_node = alpha != beta - 1, search_result, order;
-  int moves_done = 0, bestmove, type;
+  int moves_done = 0, bestmove, type, root_time = 0;
+  uint64_t root_nodes = 0;
 
 /*
  ************************************************************
@@ -448,6 +474,10 @@ int SearchMoveList(TREE * RESTRICT tree, int ply, int depth, int wtm,
       Trace(tree, ply, depth, wtm, alpha, beta, "SearchMoveList", mode,
           current->phase[ply], order);
 #endif
+    if (ply == 1) {
+      root_nodes = tree->nodes_searched;
+      root_time = ReadClock();
+    }
     MakeMove(tree, ply, wtm, tree->curmv[ply]);
     tree->nodes_searched++;
     search_result = ILLEGAL;
@@ -608,6 +638,32 @@ int SearchMoveList(TREE * RESTRICT tree, int ply, int depth, int wtm,
         }
       } while (0);
     UnmakeMove(tree, ply, wtm, tree->curmv[ply]);
+/*
+ ************************************************************
+ *                                                          *
+ *  Root move accounting.  At ply=1 we charge the nodes and *
+ *  time spent on this move (including any nodes searched   *
+ *  by helper threads below it, which are added back into   *
+ *  this tree when they join) to its root_moves[] entry,    *
+ *  and remember its score and bound.  Iterate() clears     *
+ *  these at the start of each iteration and writes them    *
+ *  to the "rootlog" file at the end of it.                 *
+ *                                                          *
+ ************************************************************
+ */
+    if (ply == 1 && search_result != ILLEGAL) {
+      for (i = 0; i < n_root_moves; i++)
+        if (root_moves[i].move == tree->curmv[1]) {
+          root_moves[i].nodes += tree->nodes_searched - root_nodes;
+          root_moves[i].time += ReadClock() - root_time;
+          if (!abort_search && !tree->stop) {
+            root_moves[i].score = value;
+            root_moves[i].bound =
+                (value <= alpha) ? UPPER : (value >= beta) ? LOWER : EXACT;
+          }
+          break;
+        }
+    }
     if (abort_search || tree->stop)
       break;
 /*
@@ -651,8 +707,8 @@ int SearchMoveList(TREE * RESTRICT tree, int ply, int depth, int wtm,
       }
 #if (CPUS > 1)
       if (mode == parallel) {
-        Lock(lock_smp);
-        Lock(tree->parent->lock);
+        LockTimed(lock_smp, thread[tree->thread_id]);
+        LockTimed(tree->parent->lock, thread[tree->thread_id]);
         if (!tree->stop) {
           int proc;
 
@@ -1,6 +1,6 @@
 #include "chess.h"
 #include "data.h"
-/* last modified 05/16/14 */
+/* last modified 10/19/26 */
 /*
  *******************************************************************************
  *                                                                             *
@@ -18,9 +18,17 @@
  *   rook/queen and then add those in to the attackers, removing any attacks   *
  *   that have already been used.                                              *
  *                                                                             *
+ *   The initial set of attackers for the last <target> square examined at     *
+ *   each ply is remembered in see_attacks[ply]/see_target[ply].  Since the    *
+ *   captures are sorted MVV/LVA, several captures of the same piece are       *
+ *   examined one after the other, and only the first needs AttacksTo().  The  *
+ *   target is cleared as the captures are generated at <ply>, and the         *
+ *   position at <ply> is always restored before the next call, so the saved   *
+ *   attackers remain correct.                                                 *
+ *                                                                             *
  *******************************************************************************
  */
-int SEE(TREE * RESTRICT tree, int wtm, int move) {
+int SEE(TREE * RESTRICT tree, int ply, int wtm, int move) {
   uint64_t attacks, temp = 0, toccupied = OccupiedSquares;
   uint64_t bsliders =
       Bishops(white) | Bishops(black) | Queens(white) | Queens(black);
@@ -32,13 +40,20 @@ int SEE(TREE * RESTRICT tree, int wtm, int move) {
 /*
  ************************************************************
  *                                                          *
- *  Determine which squares attack <target> for each side.  *
+ *  Determine which squares attack <target> for each side,  *
+ *  unless we have already done so at this ply.  Then       *
  *  initialize by placing the piece on <target> first in    *
  *  the list as it is being captured to start things off.   *
  *                                                          *
  ************************************************************
  */
-  attacks = AttacksTo(tree, target);
+  if (tree->see_target[ply] == target)
+    attacks = tree->see_attacks[ply];
+  else {
+    attacks = AttacksTo(tree, target);
+    tree->see_attacks[ply] = attacks;
+    tree->see_target[ply] = target;
+  }
   attacked_piece = pcval[Captured(move)];
 /*
  ************************************************************
@@ -232,6 +232,21 @@ void TestEPD(char *filename, FILE * unsolved, int screen, int margin) {
   float avg_depth = 0.0;
   char *eof, *mvs, *title, tbuffer[512], failed[4096];
 
+/*
+ ************************************************************
+ *                                                          *
+ *  If "testmt" has been set, hand the whole suite over to  *
+ *  TestEPDParallel() which solves several positions at     *
+ *  once, one per worker process.                           *
+ *                                                          *
+ ************************************************************
+ */
+#if defined(UNIX)
+  if (test_workers > 1) {
+    TestEPDParallel(filename, unsolved, screen, margin);
+    return;
+  }
+#endif
 /*
  ************************************************************
  *                                                          *
@@ -410,6 +425,8 @@ void TestEPD(char *filename, FILE * unsolved, int screen, int margin) {
     Print(4095, "average search depth..............%12.1f\n", avg_depth / r);
     Print(4095, "nodes per second..................%12" PRIu64 "\n",
         nodes * 100 / Max(1, time));
+    Print(4095, "positions per minute..............%12.1f\n",
+        (float) r * 6000 / Max(1, time));
     Print(4095, "total time........................%12s\n",
         DisplayTime(time));
   }
@@ -417,3 +434,366 @@ void TestEPD(char *filename, FILE * unsolved, int screen, int margin) {
   early_exit = 99;
   fclose(test_input);
 }
+#if defined(UNIX)
+#  include <sys/mman.h>
+#  include <sys/wait.h>
+/* last modified 10/19/26 */
+/*
+ *******************************************************************************
+ *                                                                             *
+ *   TestEPDParallel() is a version of TestEPD() that solves several test      *
+ *   positions at the same time.  Rather than having every thread search one   *
+ *   position (which is what TestEPD() does when smpmt > 1), this forks        *
+ *   "test_workers" copies of Crafty.  Each copy is a completely independent   *
+ *   serial search with its own TREE, and its own slice of the hash tables so  *
+ *   that the total memory used is the same as for a normal test run.          *
+ *                                                                             *
+ *   The workers pull the next unsolved record from a counter in a small       *
+ *   shared memory page, so that a hard position does not hold up the rest of  *
+ *   a worker's share.  Each result is written back to the parent through a    *
+ *   pipe as a fixed-size TEST_RESULT record.  The parent then prints results  *
+ *   in the original record order, so the output and the unsolved file look    *
+ *   just like a normal TestEPD() run, other than the search output itself     *
+ *   which is discarded.                                                       *
+ *                                                                             *
+ *   This is intended for large tactical suites at short time limits, where    *
+ *   one position per cpu is far more efficient than splitting a single tree.  *
+ *                                                                             *
+ *******************************************************************************
+ */
+void TestEPDParallel(char *filename, FILE * unsolved, int screen, int margin) {
+  TREE *const tree = block[0];
+  FILE *test_input, *test_output = 0;
+  TEST_RESULT result, *results;
+  volatile int *next_record;
+  uint64_t nodes = 0;
+  int i, j, move, right = 0, wrong = 0, culled = 0, lost = 0, nrecords = 0;
+  int printed = 0, searched = 0, workers, len, fds[2];
+  unsigned start, elapsed;
+  float avg_depth = 0.0;
+  char **records = 0, *done, *delim, *mvs, *title;
+  pid_t pid;
+
+/*
+ ************************************************************
+ *                                                          *
+ *  Read the entire suite into memory first.  Every worker  *
+ *  needs access to every record since we don't know ahead  *
+ *  of time which worker will solve which position.         *
+ *                                                          *
+ ************************************************************
+ */
+  if (!(test_input = fopen(filename, "r"))) {
+    printf("file %s does not exist.\n", filename);
+    return;
+  }
+  if (screen) {
+    char outfile[256];
+
+    strcpy(outfile, filename);
+    strcat(outfile, ".screened");
+    if (!(test_output = fopen(outfile, "w"))) {
+      printf("file %s cannot be opened for write.\n", filename);
+      fclose(test_input);
+      return;
+    }
+  }
+  while (fgets(buffer, 4096, test_input)) {
+    delim = strchr(buffer, '\n');
+    if (delim)
+      *delim = 0;
+    delim = strchr(buffer, '\r');
+    if (delim)
+      *delim = 0;
+    if (!buffer[0])
+      continue;
+    if (nrecords % 1024 == 0)
+      records = (char **) realloc(records, (nrecords + 1024) * sizeof(char *));
+    records[nrecords++] = strdup(buffer);
+  }
+  fclose(test_input);
+  if (!nrecords) {
+    if (test_output)
+      fclose(test_output);
+    return;
+  }
+  if (book_file) {
+    fclose(book_file);
+    book_file = 0;
+  }
+  if (books_file) {
+    fclose(books_file);
+    books_file = 0;
+  }
+/*
+ ************************************************************
+ *                                                          *
+ *  Set up the shared record counter and the result pipe,   *
+ *  then start the workers.  stdout and the log file are    *
+ *  flushed first so that buffered output is not written a  *
+ *  second time by each child process.                      *
+ *                                                          *
+ ************************************************************
+ */
+  next_record =
+      (volatile int *) mmap(0, sizeof(int), PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_ANON, -1, 0);
+  if (next_record == MAP_FAILED || pipe(fds)) {
+    printf("ERROR.  unable to set up test workers, running serially.\n");
+    for (i = 0; i < nrecords; i++)
+      free(records[i]);
+    free(records);
+    if (test_output)
+      fclose(test_output);
+    test_workers = 0;
+    TestEPD(filename, unsolved, screen, margin);
+    return;
+  }
+  *next_record = 0;
+  workers = Min(test_workers, nrecords);
+  Print(4095, "running %d positions using %d worker processes.\n", nrecords,
+      workers);
+  fflush(stdout);
+  if (log_file)
+    fflush(log_file);
+  if (unsolved)
+    fflush(unsolved);
+  start = ReadClock();
+  for (i = 0; i < workers; i++) {
+    pid = fork();
+    if (pid < 0) {
+      Print(2048, "ERROR.  fork() failed, using %d workers.\n", i);
+      workers = i;
+      break;
+    }
+    if (pid)
+      continue;
+/*
+ ************************************************************
+ *                                                          *
+ *  This is a worker process.  InitializeWorker() sets it   *
+ *  up for a quiet serial search using 1/Nth of each hash   *
+ *  table, then we solve records until none are left.       *
+ *                                                          *
+ ************************************************************
+ */
+    close(fds[0]);
+    InitializeWorker(workers);
+    while ((j = __sync_fetch_and_add(next_record, 1)) < nrecords) {
+      memset(&result, 0, sizeof(TEST_RESULT));
+      result.record = j;
+      strcpy(buffer, records[j]);
+      mvs = strstr(buffer, " sd ");
+      if (mvs) {
+        search_depth = atoi(mvs + 3);
+        *(mvs - 1) = 0;
+      }
+      mvs = strstr(buffer, " bm ");
+      if (!mvs)
+        mvs = strstr(buffer, " am ");
+      title = strstr(buffer, "id");
+      if (mvs)
+        *mvs++ = 0;
+      if (title) {
+        *(title - 1) = 0;
+        title = strchr(title, '\"');
+        if (title) {
+          title++;
+          if (strchr(title, '\"'))
+            *strchr(title, '\"') = 0;
+          strncpy(result.title, title, sizeof(result.title) - 1);
+        }
+      }
+      Option(tree);
+      number_of_solutions = 0;
+      solution_type = 0;
+      if (mvs) {
+        nargs = ReadParse(mvs, args, " \t;");
+        if (!strcmp(args[0], "am"))
+          solution_type = 1;
+        for (i = 1; i < nargs && number_of_solutions < 10; i++) {
+          if (!strcmp(args[i], "c0"))
+            break;
+          move = InputMove(tree, 0, game_wtm, 0, 0, args[i]);
+          if (move) {
+            solutions[number_of_solutions++] = move;
+            len = strlen(result.solution);
+            snprintf(result.solution + len, sizeof(result.solution) - len,
+                "%d. %s%s", number_of_solutions, OutputMove(tree, 0,
+                    game_wtm, move), (solution_type) ? "? " : "  ");
+          }
+        }
+      }
+      InitializeHashTables(0);
+      last_pv.pathd = 0;
+      thinking = 1;
+      tree->status[1] = tree->status[0];
+      Iterate(game_wtm, think, 0);
+      thinking = 0;
+      result.nodes = tree->nodes_searched;
+      result.depth = iteration;
+      result.time = end_time - start_time;
+      result.value = last_root_value;
+      result.wtm = game_wtm;
+      move = tree->pv[1].path[1] & 0x001fffff;
+      if (move)
+        strcpy(result.best, OutputMove(tree, 0, game_wtm, move));
+      result.correct = solution_type;
+      for (i = 0; i < number_of_solutions; i++) {
+        if (!solution_type) {
+          if (solutions[i] == move)
+            result.correct = 1;
+        } else if (solutions[i] == move)
+          result.correct = 0;
+      }
+      if (write(fds[1], &result, sizeof(TEST_RESULT)) != sizeof(TEST_RESULT))
+        _exit(1);
+    }
+    close(fds[1]);
+    _exit(0);
+  }
+  close(fds[1]);
+/*
+ ************************************************************
+ *                                                          *
+ *  Collect the results.  They arrive in whatever order the *
+ *  workers finish them, so we hold each one until all of   *
+ *  the earlier records have been displayed.                *
+ *                                                          *
+ ************************************************************
+ */
+  results = (TEST_RESULT *) calloc(nrecords, sizeof(TEST_RESULT));
+  done = (char *) calloc(nrecords, 1);
+  while (printed < nrecords) {
+    if (read(fds[0], &result, sizeof(TEST_RESULT)) != sizeof(TEST_RESULT))
+      break;
+    results[result.record] = result;
+    done[result.record] = 1;
+    for (; printed < nrecords && done[printed]; printed++) {
+      TestEPDResult(results + printed, records[printed], unsolved,
+          test_output, screen, margin, &right, &wrong, &culled, &nodes,
+          &avg_depth);
+      searched++;
+    }
+  }
+  close(fds[0]);
+  while (wait(0) > 0);
+  elapsed = ReadClock() - start;
+/*
+ ************************************************************
+ *                                                          *
+ *  If a worker died, the pipe hit EOF at the first record  *
+ *  it never finished.  Results for later records may have  *
+ *  already arrived, so score those too, and only count the *
+ *  records that really have no result as lost.             *
+ *                                                          *
+ ************************************************************
+ */
+  for (i = printed; i < nrecords; i++)
+    if (done[i]) {
+      TestEPDResult(results + i, records[i], unsolved, test_output, screen,
+          margin, &right, &wrong, &culled, &nodes, &avg_depth);
+      searched++;
+    } else {
+      Print(2048, "ERROR.  no result for record #%d, worker failed.\n",
+          i + 1);
+      lost++;
+    }
+/*
+ ************************************************************
+ *                                                          *
+ *  Now print the results.  Nodes per second is the total   *
+ *  for all workers, measured against wall-clock time.      *
+ *                                                          *
+ ************************************************************
+ */
+  Print(4095, "\n\n\n");
+  Print(4095, "test results summary:\n\n");
+  Print(4095, "total positions searched..........%12d\n", searched);
+  if (!screen) {
+    Print(4095, "number right......................%12d\n", right);
+    Print(4095, "number wrong......................%12d\n", wrong);
+    Print(4095, "percentage right..................%12d\n",
+        right * 100 / Max(1, right + wrong));
+    Print(4095, "percentage wrong..................%12d\n",
+        wrong * 100 / Max(1, right + wrong));
+  } else
+    Print(4095, "records excluded..................%12d\n", culled);
+  if (lost)
+    Print(4095, "positions lost....................%12d\n", lost);
+  Print(4095, "total nodes searched..............%12" PRIu64 "\n", nodes);
+  Print(4095, "average search depth..............%12.1f\n",
+      avg_depth / Max(1, searched));
+  Print(4095, "nodes per second..................%12" PRIu64 "\n",
+      nodes * 100 / Max(1, elapsed));
+  Print(4095, "positions per minute..............%12.1f\n",
+      (float) searched * 6000 / Max(1, elapsed));
+  Print(4095, "worker processes..................%12d\n", workers);
+  Print(4095, "total time........................%12s\n",
+      DisplayTime(elapsed));
+  for (i = 0; i < nrecords; i++)
+    free(records[i]);
+  free(records);
+  free(results);
+  free(done);
+  munmap((void *) next_record, sizeof(int));
+  if (test_output)
+    fclose(test_output);
+  input_stream = stdin;
+  early_exit = 99;
+}
+/* last modified 10/19/26 */
+/*
+ *******************************************************************************
+ *                                                                             *
+ *   TestEPDResult() displays and scores one result collected by               *
+ *   TestEPDParallel(), exactly as TestEPD() would have after searching that   *
+ *   record, and updates the running totals for the summary.                   *
+ *                                                                             *
+ *******************************************************************************
+ */
+void TestEPDResult(TEST_RESULT * r, char *record, FILE * unsolved,
+    FILE * test_output, int screen, int margin, int *right, int *wrong,
+    int *culled, uint64_t * nodes, float *avg_depth) {
+  int i, len;
+
+  Print(4095, "%s\n", record);
+  if (r->title[0]) {
+    Print(4095,
+        "=============================================="
+        "========================\n");
+    Print(4095, "! %s ", r->title);
+    len = 66 - strlen(r->title);
+    for (i = 0; i < len; i++)
+      printf(" ");
+    Print(4095, "!\n");
+    Print(4095,
+        "=============================================="
+        "========================\n");
+  }
+  *nodes += r->nodes;
+  *avg_depth += (float) r->depth;
+  if (screen) {
+    if (Abs(r->value) < margin)
+      fprintf(test_output, "%s\n", record);
+    else
+      (*culled)++;
+    return;
+  }
+  Print(4095, "solution %s\n", r->solution);
+  Print(4095, "best move %s  depth=%d  time=%s", r->best, r->depth,
+      DisplayTime(r->time));
+  Print(4095, "  score=%s\n", DisplayEvaluation(r->value, r->wtm));
+  if (r->correct) {
+    (*right)++;
+    Print(4095, "----------------------> solution correct (%d/%d).\n",
+        *right, *right + *wrong);
+  } else {
+    (*wrong)++;
+    Print(4095, "----------------------> solution incorrect (%d/%d).\n",
+        *right, *right + *wrong);
+    if (unsolved)
+      fprintf(unsolved, "%s\n", record);
+  }
+}
+#endif
@@ -111,7 +111,8 @@
  *   smp_split_at_root (command = smproot=0 or 1) enables (1) or disables (0)  *
  *      splitting the tree at the root.  This defaults to 1 which produces the *
  *      best performance by a signficiant margin.  But it can be disabled if   *
- *      you are playing with code changes.                                     *
+ *      you are playing with code changes.  2 also allows splitting at the     *
+ *      root before the moves that were best recently have been searched.      *
  *                                                                             *
  *   smp_gratuitous_depth (command = smpgd=<n>) controls " gratuitous splits"  *
  *      which are splits that are done without any idle threads.  This sets a  *
@@ -207,6 +208,7 @@ int Split(TREE * RESTRICT tree) {
   thread[tree->thread_id].tree = child;
   tree->joined = 0;
   tree->joinable = 1;
+  AtomicSet(tree->block_id & 63, smp_joinable[tree->block_id >> 6]);
   parallel_splits++;
   smp_split = 0;
   tend = ReadClock();
@@ -258,7 +260,8 @@ int Split(TREE * RESTRICT tree) {
  */
 int Join(int64_t tid) {
   TREE *tree, *join_block, *child;
-  int interest, best_interest, current, pass = 0;
+  uint64_t joinable;
+  int interest, best_interest, current, word, pass = 0;
 
 /*
  ************************************************************
@@ -293,19 +296,37 @@ int Join(int64_t tid) {
  *  avoid most (if not all) of this overhead, but there is  *
  *  no good reason to take the chance of this happening.    *
  *                                                          *
+ *  Rather than looking at every split block, we normally   *
+ *  (smpjoinmap=1) only look at the blocks with a bit set   *
+ *  in smp_joinable[], which has one bit per split block    *
+ *  (block N is bit N&63 of word N/64).  The bit is set and *
+ *  cleared with atomic operations right along with the     *
+ *  "joinable" flag, so idle threads can find split points  *
+ *  by reading a few words rather than pulling the flag     *
+ *  from 64 split blocks per thread into their cache.  The  *
+ *  bit is only a hint, so the joinable flag is still       *
+ *  checked.  smpjoinmap=0 looks at every block as before.  *
+ *                                                          *
  ************************************************************
  */
   for (pass = 0; pass < 3; pass++) {
     best_interest = -999999;
     join_block = 0;
-    for (current = 0; current <= smp_max_threads * 64; current++) {
-      tree = block[current];
-      if (tree->joinable && (tree->ply <= tree->depth / 2 ||
-              tree->nprocs < smp_split_group) && tree->thread_id != tid) {
-        interest = tree->depth * 2 - tree->searched[0];
-        if (interest > best_interest) {
-          best_interest = interest;
-          join_block = tree;
+    for (word = 0; word <= smp_max_threads; word++) {
+      joinable = (smp_join_map) ? smp_joinable[word] : ~(uint64_t) 0;
+      while (joinable) {
+        current = LSB(joinable) + word * 64;
+        Clear(current & 63, joinable);
+        if (current > smp_max_threads * 64)
+          break;
+        tree = block[current];
+        if (tree->joinable && (tree->ply <= tree->depth / 2 ||
+                tree->nprocs < smp_split_group) && tree->thread_id != tid) {
+          interest = tree->depth * 2 - tree->searched[0];
+          if (interest > best_interest) {
+            best_interest = interest;
+            join_block = tree;
+          }
         }
       }
     }
@@ -344,7 +365,7 @@ int Join(int64_t tid) {
  ************************************************************
  */
     if (join_block) {
-      Lock(join_block->lock);
+      LockTimed(join_block->lock, thread[tid]);
       if (join_block->joinable) {
         child = GetBlock(join_block, tid);
         Unlock(join_block->lock);
@@ -561,6 +582,7 @@ void ThreadStop(TREE * RESTRICT tree) {
   Lock(tree->lock);
   tree->stop = 1;
   tree->joinable = 0;
+  AtomicClear(tree->block_id & 63, smp_joinable[tree->block_id >> 6]);
   for (proc = 0; proc < smp_max_threads; proc++)
     if (tree->siblings[proc])
       ThreadStop(tree->siblings[proc]);
@@ -714,8 +736,10 @@ int ThreadWait(int tid, TREE * RESTRICT waiting) {
         thread[tid].tree->alpha, thread[tid].tree->beta,
         thread[tid].tree->searched, thread[tid].tree->in_check, 0, parallel);
     tstart = ReadClock();
-    Lock(thread[tid].tree->parent->lock);
+    LockTimed(thread[tid].tree->parent->lock, thread[tid]);
     thread[tid].tree->parent->joinable = 0;
+    AtomicClear(thread[tid].tree->parent->block_id & 63,
+        smp_joinable[thread[tid].tree->parent->block_id >> 6]);
     CopyToParent((TREE *) thread[tid].tree->parent, thread[tid].tree, value);
     thread[tid].tree->parent->nprocs--;
     thread[tid].tree->parent->siblings[tid] = 0;
@@ -754,6 +778,10 @@ void CopyFromParent(TREE * RESTRICT child) {
   child->position = parent->position;
   for (i = 0; i <= rep_index + parent->ply; i++)
     child->rep_list[i] = parent->rep_list[i];
+  memcpy(child->rep_filter, parent->rep_filter, sizeof(child->rep_filter));
+  for (i = parent->rep_top; i > rep_index + parent->ply; i--)
+    child->rep_filter[RepFilter(parent->rep_list[i])]--;
+  child->rep_top = Min(parent->rep_top, rep_index + parent->ply);
   for (i = ply - 1; i < MAXPLY; i++)
     child->killers[i] = parent->killers[i];
   for (i = 0; i < 4096; i++) {
@@ -774,8 +802,13 @@ void CopyFromParent(TREE * RESTRICT child) {
   child->fail_highs = 0;
   child->fail_high_first_move = 0;
   child->evaluations = 0;
+  child->eval_cache_hits = 0;
   child->egtb_probes = 0;
   child->egtb_hits = 0;
+  child->egtb_cache_hits = 0;
+  child->egtb_probe_time = 0;
+  for (i = 0; i < 8; i++)
+    child->egtb_probe_times[i] = 0;
   child->extensions_done = 0;
   child->qchecks_done = 0;
   child->moves_fpruned = 0;
@@ -854,8 +887,13 @@ void CopyToParent(TREE * RESTRICT parent, TREE * RESTRICT child, int value) {
   parent->fail_highs += child->fail_highs;
   parent->fail_high_first_move += child->fail_high_first_move;
   parent->evaluations += child->evaluations;
+  parent->eval_cache_hits += child->eval_cache_hits;
   parent->egtb_probes += child->egtb_probes;
   parent->egtb_hits += child->egtb_hits;
+  parent->egtb_cache_hits += child->egtb_cache_hits;
+  parent->egtb_probe_time += child->egtb_probe_time;
+  for (i = 0; i < 8; i++)
+    parent->egtb_probe_times[i] += child->egtb_probe_times[i];
   parent->extensions_done += child->extensions_done;
   parent->qchecks_done += child->qchecks_done;
   parent->moves_fpruned += child->moves_fpruned;
@@ -952,6 +990,8 @@ TREE *GetBlock(TREE * RESTRICT parent, int tid) {
   child->joined = 0;
   child->parent = parent;
   child->thread_id = tid;
+  child->block_id = unused + tid * 64 + 1;
+  AtomicClear(child->block_id & 63, smp_joinable[child->block_id >> 6]);
   parent->nprocs++;
   parent->siblings[tid] = child;
   parent->joined = 1;
@@ -308,7 +308,13 @@ int CheckInput(void) {
 }
 #endif
 #if defined(UNIX)
-/* Simple UNIX approach using select with a zero timeout value */
+/*
+ Simple UNIX approach using select with a zero timeout value.  Once
+ the input reader thread has been started (see ReadInputThread()) we
+ never need the select() since the thread tells us when a complete
+ command has been queued, so the search only reads a couple of
+ memory locations here rather than making a system call.
+ */
 int CheckInput(void) {
   fd_set readfds;
   struct timeval tv;
@@ -320,6 +326,10 @@ int CheckInput(void) {
     return 0;
   if (strchr(cmd_buffer, '\n'))
     return 1;
+#  if (CPUS > 1)
+  if (input_thread)
+    return input_head != input_tail || input_eof;
+#  endif
   FD_ZERO(&readfds);
   FD_SET(fileno(stdin), &readfds);
   tv.tv_sec = 0;
@@ -1321,6 +1331,27 @@ unsigned int ReadClock(void) {
 #endif
 }
 
+/*
+ *******************************************************************************
+ *                                                                             *
+ *   ReadClockUsec() is the same as ReadClock() but returns microseconds.  It  *
+ *   is used to time short operations like an EGTB probe where a resolution   *
+ *   of 1/100th of a second is useless.                                        *
+ *                                                                             *
+ *******************************************************************************
+ */
+uint64_t ReadClockUsec(void) {
+#if defined(UNIX)
+  struct timeval timeval;
+  struct timezone timezone;
+
+  gettimeofday(&timeval, &timezone);
+  return (uint64_t) timeval.tv_sec * 1000000 + timeval.tv_usec;
+#else
+  return (uint64_t) GetTickCount() * 1000;
+#endif
+}
+
 /*
  *******************************************************************************
  *                                                                             *
@@ -1822,9 +1853,29 @@ int ReadInput(void) {
   int bytes;
   char buffer[4096], *end;
 
-  do
-    bytes = read(fileno(input_stream), buffer, 2048);
-  while (bytes < 0 && errno == EINTR);
+#if defined(UNIX) && (CPUS > 1)
+  if (input_stream == stdin) {
+    pthread_t pt;
+
+    if (!input_thread) {
+      pthread_create(&pt, &attributes, ReadInputThread, (void *) 0);
+      input_thread = 1;
+    }
+    pthread_mutex_lock(&input_mutex);
+    while (input_head == input_tail && !input_eof)
+      pthread_cond_wait(&input_ready, &input_mutex);
+    pthread_mutex_unlock(&input_mutex);
+    __sync_synchronize();
+    bytes = Min(input_tail - input_head, 2048);
+    for (end = buffer; end < buffer + bytes; end++)
+      *end = input_ring[(input_head + end - buffer) & (INPUT_RING_SIZE - 1)];
+    __sync_synchronize();
+    input_head += bytes;
+  } else
+#endif
+    do
+      bytes = read(fileno(input_stream), buffer, 2048);
+    while (bytes < 0 && errno == EINTR);
   if (bytes == 0) {
     if (input_stream != stdin)
       fclose(input_stream);
@@ -1840,6 +1891,58 @@ int ReadInput(void) {
   return 1;
 }
 
+#if defined(UNIX) && (CPUS > 1)
+/*
+ *******************************************************************************
+ *                                                                             *
+ *   ReadInputThread() is the input reader thread.  It is started the first    *
+ *   time ReadInput() reads from stdin and from then on it is the only thing   *
+ *   that reads stdin.  It sits in a blocking read(), and each time a complete *
+ *   command line (or several) has arrived, it appends them to input_ring[]    *
+ *   and then advances input_tail.  input_ring[] is a single producer, single  *
+ *   consumer queue, this thread only changes input_tail and ReadInput() only  *
+ *   changes input_head, so no lock is needed to pass the data.  The mutex and *
+ *   condition variable are only used to wake ReadInput() when it is blocked   *
+ *   waiting for a command.  CheckInput() simply compares input_head and       *
+ *   input_tail, so the search no longer needs a select() system call to see   *
+ *   if xboard has sent something.                                             *
+ *                                                                             *
+ *******************************************************************************
+ */
+void *STDCALL ReadInputThread(void *arg) {
+  char buffer[4096];
+  int bytes, used = 0, end, i;
+
+  while (FOREVER) {
+    do
+      bytes = read(fileno(stdin), buffer + used, sizeof(buffer) - used);
+    while (bytes < 0 && errno == EINTR);
+    if (bytes > 0)
+      used += bytes;
+    for (end = used; end > 0 && buffer[end - 1] != '\n'; end--);
+    if (bytes <= 0 || used == sizeof(buffer))
+      end = used;
+    if (end) {
+      while (INPUT_RING_SIZE - (input_tail - input_head) < end)
+        usleep(1000);
+      for (i = 0; i < end; i++)
+        input_ring[(input_tail + i) & (INPUT_RING_SIZE - 1)] = buffer[i];
+      __sync_synchronize();
+      input_tail += end;
+      memmove(buffer, buffer + end, used - end);
+      used -= end;
+    }
+    if (bytes <= 0)
+      input_eof = 1;
+    pthread_mutex_lock(&input_mutex);
+    pthread_cond_signal(&input_ready);
+    pthread_mutex_unlock(&input_mutex);
+    if (bytes <= 0)
+      return 0;
+  }
+}
+#endif
+
 /*
  *******************************************************************************
  *                                                                             *
@@ -2275,6 +2378,8 @@ void Output(TREE * RESTRICT tree) {
   if (!abort_search) {
     kibitz_depth = iteration;
     end_time = ReadClock();
+    if (!hash_path_size && tree->pv[1].pathh == 1)
+      HashPV(tree, wtm, &tree->pv[1]);
     DisplayPV(tree, 6, wtm, end_time - start_time, &tree->pv[1], 0);
     for (i = 0; i < n_root_moves; i++)
       if (tree->pv[1].path[1] == root_moves[i].move)
@@ -214,8 +214,8 @@ void adapter_loop() {
 
 static void adapter_step() {
 
-   fd_set set[1];
-   int fd_max;
+   int fd[2];
+   int ready[2];
    int val;
 
    // process buffered lines
@@ -223,35 +223,22 @@ static void adapter_step() {
    while (io_line_ready(XBoard->io)) xboard_step(); // process available xboard lines
    while (io_line_ready(Engine->io)) engine_step(); // process available engine lines
 
-   // init
-
-   FD_ZERO(set);
-   fd_max = -1; // HACK
-
-   // add xboard input
+   // add xboard and engine input
 
    ASSERT(XBoard->io->in_fd>=0);
-
-   FD_SET(XBoard->io->in_fd,set);
-   if (XBoard->io->in_fd > fd_max) fd_max = XBoard->io->in_fd;
-
-   // add engine input
-
    ASSERT(Engine->io->in_fd>=0);
 
-   FD_SET(Engine->io->in_fd,set);
-   if (Engine->io->in_fd > fd_max) fd_max = Engine->io->in_fd;
+   fd[0] = XBoard->io->in_fd;
+   fd[1] = Engine->io->in_fd;
 
    // wait for something to read (no timeout)
 
-   ASSERT(fd_max>=0);
-
-   val = select(fd_max+1,set,NULL,NULL,NULL);
+   val = PollInput(2,fd,ready,true);
    if (val == -1 && errno != EINTR) my_fatal("adapter_step(): select(): %s\n",strerror(errno));
 
    if (val > 0) {
-      if (FD_ISSET(XBoard->io->in_fd,set)) io_get_update(XBoard->io); // read some xboard input
-      if (FD_ISSET(Engine->io->in_fd,set)) io_get_update(Engine->io); // read some engine input
+      if (ready[0]) io_get_update(XBoard->io); // read some xboard input
+      if (ready[1]) io_get_update(Engine->io); // read some engine input
    }
 }
 
@@ -486,6 +473,10 @@ static void xboard_step() {
       xboard_send(XBoard,"feature time=1");
       xboard_send(XBoard,"feature usermove=1");
 
+      if (uci_option_exist(Uci,"Threads")) {
+         xboard_send(XBoard,"feature smp=1");
+      }
+
       if (uci_option_exist(Uci,"UCI_Chess960")) {
          xboard_send(XBoard,"feature variants=\"normal,fischerandom\"");
       } else {
@@ -691,7 +682,7 @@ static void xboard_step() {
 
       // TODO Invoke Polyglot's book functionality
       // Subcommands: add, on, off, prefer, random, best, worst
-      char *my_argv[4];
+      char *my_argv[6];
       char *token;
       token = strtok( Star[0], " " );
 
@@ -701,11 +692,29 @@ static void xboard_step() {
          my_argv[1] = (char *)malloc( 10 );
          my_argv[2] = (char *)malloc( 5 );
          my_argv[3] = (char *)malloc( strlen(token) + 1 );
+         my_argv[4] = (char *)malloc( 9 );
+         my_argv[5] = (char *)malloc( 2 );
+         strcpy( my_argv[0], "g" );
+         strcpy( my_argv[1], "make-book" );
+         strcpy( my_argv[2], "-pgn" );
+         strcpy( my_argv[3], token );
+         strcpy( my_argv[4], "-threads" ); // one per processor
+         strcpy( my_argv[5], "0" );
+         book_make( 6, my_argv );
+
+      } else if ( strcmp( token, "bench" ) == 0 ) {
+         token = strtok( NULL, " " );
+         my_argv[0] = (char *)malloc( 2 );
+         my_argv[1] = (char *)malloc( 10 );
+         my_argv[2] = (char *)malloc( 5 );
+         my_argv[3] = (char *)malloc( strlen(token) + 1 );
+         my_argv[4] = (char *)malloc( 11 );
          strcpy( my_argv[0], "g" );
          strcpy( my_argv[1], "make-book" );
          strcpy( my_argv[2], "-pgn" );
          strcpy( my_argv[3], token );
-         book_make( 4, my_argv );
+         strcpy( my_argv[4], "-bench-pgn" ); // time the PGN reader, no book
+         book_make( 5, my_argv );
 
       } else if ( strcmp( token, "on" ) == 0 ) {
 
@@ -760,6 +769,12 @@ static void xboard_step() {
       }
       engine_send(Uci->engine,"uci");
 
+   } else if (match(string,"cores *")) { // cores N command (xboard protocol 2)
+
+      if (uci_option_exist(Uci,"Threads")) {
+         uci_send_option(Uci,"Threads","%s",Star[0]);
+      }
+
    } else if (match(string,"nullon")) { // null on command (from GNU Chess v5)
 
       uci_send_option(Uci,"NullMove Pruning","%s","Always");
@@ -28,6 +28,9 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <sys/types.h>
+#include <sys/mman.h>
+
 #include "board.h"
 #include "book.h"
 #include "move.h"
@@ -51,16 +54,21 @@ struct entry_t {
 
 static FILE * BookFile;
 static int BookSize;
+static int BookMode;
+
+static uint8 * BookData; // BookSize big-endian 16-byte entries
+static bool BookMapped; // false => BookData is a private copy of the file
 
 // prototypes
 
 static int    find_pos      (uint64 key);
 
+static uint64 read_key      (int n);
 static void   read_entry    (entry_t * entry, int n);
 static void   write_entry   (const entry_t * entry, int n);
 
-static uint64 read_integer  (FILE * file, int size);
-static void   write_integer (FILE * file, int size, uint64 n);
+static uint64 read_integer  (const uint8 data[], int size);
+static void   write_integer (uint8 data[], int size, uint64 n);
 
 // functions
 
@@ -70,6 +78,10 @@ void book_clear() {
 
    BookFile = NULL;
    BookSize = 0;
+   BookMode = BookReadOnly;
+
+   BookData = NULL;
+   BookMapped = false;
 }
 
 // book_open()
@@ -79,6 +91,8 @@ void book_open(const char file_name[], int mode) {
    ASSERT(file_name!=NULL);
    ASSERT(mode==BookReadOnly || mode==BookReadWrite);
 
+   if (BookFile != NULL) book_close(); // "book on" while a book is open
+
    const int MaxModeLength = 4;
    char full_file_name[MaxFileNameSize+1];
    char file_open_mode[MaxModeLength]="";
@@ -113,15 +127,49 @@ void book_open(const char file_name[], int mode) {
 
    BookSize = ftell(BookFile) / 16;
    if (BookSize == 0) my_fatal("book_open(): empty file\n");
+
+   BookMode = mode;
+
+   // map the file, so that probes are memory reads and learning writes go straight to it
+
+   BookData = (uint8 *) mmap(NULL,size_t(BookSize)*16,(mode==BookReadWrite)?PROT_READ|PROT_WRITE:PROT_READ,MAP_SHARED,fileno(BookFile),0);
+
+   if (BookData != MAP_FAILED) {
+
+      BookMapped = true;
+
+   } else { // HACK: no mmap() for this file, read it all instead
+
+      BookMapped = false;
+      BookData = (uint8 *) my_malloc(BookSize*16);
+
+      if (fseek(BookFile,0,SEEK_SET) == -1) {
+         my_fatal("book_open(): fseek(): %s\n",strerror(errno));
+      }
+
+      if (fread(BookData,16,BookSize,BookFile) != size_t(BookSize)) {
+         my_fatal("book_open(): fread(): %s\n",strerror(errno));
+      }
+   }
 }
 
 // book_close()
 
 void book_close() {
 
+   if (BookMapped) {
+      if (munmap(BookData,size_t(BookSize)*16) == -1) {
+         my_fatal("book_close(): munmap(): %s\n",strerror(errno));
+      }
+   } else {
+      my_free(BookData);
+   }
+
    if (fclose(BookFile) == EOF) {
       my_fatal("book_close(): fclose(): %s\n",strerror(errno));
    }
+
+   book_clear();
 }
 
 // is_in_book()
@@ -336,6 +384,10 @@ void book_learn_move(const board_t * board, int move, int result) {
 
 void book_flush() {
 
+   if (BookMapped && msync(BookData,size_t(BookSize)*16,MS_SYNC) == -1) {
+      my_fatal("book_flush(): msync(): %s\n",strerror(errno));
+   }
+
    if (fflush(BookFile) == EOF) {
       my_fatal("book_flush(): fflush(): %s\n",strerror(errno));
    }
@@ -346,9 +398,8 @@ void book_flush() {
 static int find_pos(uint64 key) {
 
    int left, right, mid;
-   entry_t entry[1];
 
-   // binary search (finds the leftmost entry)
+   // binary search (finds the leftmost entry), only the keys are decoded
 
    left = 0;
    right = BookSize-1;
@@ -360,9 +411,7 @@ static int find_pos(uint64 key) {
       mid = (left + right) / 2;
       ASSERT(mid>=left&&mid<right);
 
-      read_entry(entry,mid);
-
-      if (key <= entry->key) {
+      if (key <= read_key(mid)) {
          right = mid;
       } else {
          left = mid+1;
@@ -371,74 +420,81 @@ static int find_pos(uint64 key) {
 
    ASSERT(left==right);
 
-   read_entry(entry,left);
+   return (read_key(left) == key) ? left : BookSize;
+}
+
+// read_key()
 
-   return (entry->key == key) ? left : BookSize;
+static uint64 read_key(int n) {
+
+   ASSERT(n>=0&&n<BookSize);
+
+   return read_integer(&BookData[size_t(n)*16],8);
 }
 
 // read_entry()
 
 static void read_entry(entry_t * entry, int n) {
 
+   const uint8 * data;
+
    ASSERT(entry!=NULL);
    ASSERT(n>=0&&n<BookSize);
 
-   if (fseek(BookFile,n*16,SEEK_SET) == -1) {
-      my_fatal("read_entry(): fseek(): %s\n",strerror(errno));
-   }
+   data = &BookData[size_t(n)*16];
 
-   entry->key   = read_integer(BookFile,8);
-   entry->move  = read_integer(BookFile,2);
-   entry->count = read_integer(BookFile,2);
-   entry->n     = read_integer(BookFile,2);
-   entry->sum   = read_integer(BookFile,2);
+   entry->key   = read_integer(data+0,8);
+   entry->move  = read_integer(data+8,2);
+   entry->count = read_integer(data+10,2);
+   entry->n     = read_integer(data+12,2);
+   entry->sum   = read_integer(data+14,2);
 }
 
 // write_entry()
 
 static void write_entry(const entry_t * entry, int n) {
 
+   uint8 * data;
+
    ASSERT(entry!=NULL);
    ASSERT(n>=0&&n<BookSize);
 
-   if (fseek(BookFile,n*16,SEEK_SET) == -1) {
-      my_fatal("write_entry(): fseek(): %s\n",strerror(errno));
-   }
+   if (BookMode != BookReadWrite) my_fatal("write_entry(): book is read only\n");
+
+   data = &BookData[size_t(n)*16];
 
-   write_integer(BookFile,8,entry->key);
-   write_integer(BookFile,2,entry->move);
-   write_integer(BookFile,2,entry->count);
-   write_integer(BookFile,2,entry->n);
-   write_integer(BookFile,2,entry->sum);
+   write_integer(data+0,8,entry->key);
+   write_integer(data+8,2,entry->move);
+   write_integer(data+10,2,entry->count);
+   write_integer(data+12,2,entry->n);
+   write_integer(data+14,2,entry->sum);
+
+   if (!BookMapped) { // write the entry back to the file
+
+      if (fseek(BookFile,long(n)*16,SEEK_SET) == -1) {
+         my_fatal("write_entry(): fseek(): %s\n",strerror(errno));
+      }
+
+      if (fwrite(data,16,1,BookFile) != 1) {
+         my_fatal("write_entry(): fwrite(): %s\n",strerror(errno));
+      }
+   }
 }
 
 // read_integer()
 
-static uint64 read_integer(FILE * file, int size) {
+static uint64 read_integer(const uint8 data[], int size) {
 
    uint64 n;
    int i;
-   int b;
 
-   ASSERT(file!=NULL);
+   ASSERT(data!=NULL);
    ASSERT(size>0&&size<=8);
 
    n = 0;
 
    for (i = 0; i < size; i++) {
-
-      b = fgetc(file);
-
-      if (b == EOF) {
-         if (feof(file)) {
-            my_fatal("read_integer(): fgetc(): EOF reached\n");
-         } else { // error
-            my_fatal("read_integer(): fgetc(): %s\n",strerror(errno));
-         }
-      }
-
-      ASSERT(b>=0&&b<256);
-      n = (n << 8) | b;
+      n = (n << 8) | data[i];
    }
 
    return n;
@@ -446,23 +502,16 @@ static uint64 read_integer(FILE * file, int size) {
 
 // write_integer()
 
-static void write_integer(FILE * file, int size, uint64 n) {
+static void write_integer(uint8 data[], int size, uint64 n) {
 
    int i;
-   int b;
 
-   ASSERT(file!=NULL);
+   ASSERT(data!=NULL);
    ASSERT(size>0&&size<=8);
    ASSERT(size==8||n>>(size*8)==0);
 
-   for (i = size-1; i >= 0; i--) {
-
-      b = (n >> (i*8)) & 0xFF;
-      ASSERT(b>=0&&b<256);
-
-      if (fputc(b,file) == EOF) {
-         my_fatal("write_integer(): fputc(): %s\n",strerror(errno));
-      }
+   for (i = 0; i < size; i++) {
+      data[i] = (n >> ((size-1-i)*8)) & 0xFF;
    }
 }
 
@@ -29,12 +29,20 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 #include "board.h"
 #include "book_make.h"
 #include "move.h"
 #include "move_do.h"
 #include "move_legal.h"
 #include "pgn.h"
+#include "posix.h"
 #include "san.h"
 #include "util.h"
 #include "book_make.h"
@@ -47,6 +55,8 @@ static const int COUNT_MAX = 16384;
 
 static const int NIL = -1;
 
+static const int ThreadMax = 64;
+
 // types
 
 struct entry_t {
@@ -65,6 +75,17 @@ struct book_t {
    sint32 * hash;
 };
 
+struct worker_t {
+   pthread_t thread;
+   const char * data; // slice of the mapped PGN file, whole games only
+   sint64 size;
+   int line;
+   int game_nb;
+   book_t book[1];
+   bool error;
+   my_trap_t trap[1]; // my_fatal() message, reported by book_insert_mt()
+};
+
 // variables
 
 static int MaxPly;
@@ -72,20 +93,32 @@ static int MinGame;
 static double MinScore;
 static bool RemoveWhite, RemoveBlack;
 static bool Uniform;
+static int ThreadNb;
+static bool BenchPgn;
+static bool InsertError; // a worker failed, the book is not saved
 
 static book_t Book[1];
 
 // prototypes
 
-static void   book_clear    ();
+static void   book_clear    (book_t * book);
+static void   book_free     (book_t * book);
+static void   bench_pgn     (const char file_name[]);
 static void   book_insert   (const char file_name[]);
+static bool   book_insert_mt (const char file_name[]);
+static int    insert_games  (book_t * book, pgn_t * pgn, bool disp);
+static void * insert_worker (void * arg);
+static void   merge_table   (book_t * dst, const book_t * src);
 static void   book_filter   ();
 static void   book_sort     ();
 static void   book_save     (const char file_name[]);
 
-static int    find_entry    (const board_t * board, int move);
-static void   resize        ();
-static void   halve_stats   (uint64 key);
+static int    find_entry    (book_t * book, uint64 key, int move, int colour);
+static void   resize        (book_t * book);
+static void   halve_stats   (book_t * book, uint64 key);
+
+static sint64 game_start    (const char data[], sint64 size, sint64 begin, sint64 pos);
+static int    line_count    (const char data[], sint64 size);
 
 static bool   keep_entry    (int pos);
 
@@ -117,6 +150,8 @@ void book_make(int argc, char * argv[]) {
    RemoveWhite = false;
    RemoveBlack = false;
    Uniform = false;
+   ThreadNb = 1;
+   BenchPgn = false;
 
    for (i = 1; i < argc; i++) {
 
@@ -178,16 +213,39 @@ void book_make(int argc, char * argv[]) {
 
          Uniform = true;
 
+      } else if (my_string_equal(argv[i],"-threads")) {
+
+         i++;
+         if (argv[i] == NULL) my_fatal("book_make(): missing argument\n");
+
+         ThreadNb = atoi(argv[i]); // 0 = one per processor
+         ASSERT(ThreadNb>=0);
+
+      } else if (my_string_equal(argv[i],"-bench-pgn")) {
+
+         BenchPgn = true;
+
       } else {
 
          my_fatal("book_make(): unknown option \"%s\"\n",argv[i]);
       }
    }
 
-   book_clear();
+   if (BenchPgn) {
+      bench_pgn(pgn_file);
+      return;
+   }
+
+   if (ThreadNb <= 0) ThreadNb = sysconf(_SC_NPROCESSORS_ONLN);
+   if (ThreadNb < 1) ThreadNb = 1;
+   if (ThreadNb > ThreadMax) ThreadNb = ThreadMax;
+
+   InsertError = false;
 
    printf("inserting games ...\n");
-   book_insert(pgn_file);
+   if (ThreadNb == 1 || !book_insert_mt(pgn_file)) book_insert(pgn_file);
+
+   if (InsertError) return; // my_fatal() does not always exit
 
    printf("filtering entries ...\n");
    book_filter();
@@ -203,28 +261,244 @@ void book_make(int argc, char * argv[]) {
 
 // book_clear()
 
-static void book_clear() {
+static void book_clear(book_t * book) {
 
    int index;
 
-   Book->alloc = 1;
-   Book->mask = (Book->alloc * 2) - 1;
+   ASSERT(book!=NULL);
+
+   book->alloc = 1;
+   book->mask = (book->alloc * 2) - 1;
 
-   Book->entry = (entry_t *) my_malloc(Book->alloc*sizeof(entry_t));
-   Book->size = 0;
+   book->entry = (entry_t *) my_malloc(book->alloc*sizeof(entry_t));
+   book->size = 0;
 
-   Book->hash = (sint32 *) my_malloc((Book->alloc*2)*sizeof(sint32));
-   for (index = 0; index < Book->alloc*2; index++) {
-      Book->hash[index] = NIL;
+   book->hash = (sint32 *) my_malloc((book->alloc*2)*sizeof(sint32));
+   for (index = 0; index < book->alloc*2; index++) {
+      book->hash[index] = NIL;
    }
 }
 
+// book_free()
+
+static void book_free(book_t * book) {
+
+   ASSERT(book!=NULL);
+
+   my_free(book->entry);
+   my_free(book->hash);
+}
+
+// bench_pgn()
+
+static void bench_pgn(const char file_name[]) {
+
+   double start, time;
+   pgn_t pgn[1];
+   int game_nb, move_nb;
+   char string[256];
+   double mb;
+
+   ASSERT(file_name!=NULL);
+
+   // PGN tokeniser speed only, the moves are not converted
+
+   start = now_real();
+
+   game_nb = 0;
+   move_nb = 0;
+
+   pgn_open(pgn,file_name);
+
+   while (pgn_next_game(pgn)) {
+      while (pgn_next_move(pgn,string,256)) move_nb++;
+      game_nb++;
+   }
+
+   mb = double(pgn->data_size) / 1048576.0;
+
+   pgn_close(pgn);
+
+   time = now_real() - start;
+
+   printf("%d games, %d moves, %.1f MB in %.2f seconds (%.1f MB/s).\n",game_nb,move_nb,mb,time,(time>0.0)?mb/time:0.0);
+}
+
 // book_insert()
 
 static void book_insert(const char file_name[]) {
 
+   double start, time;
    int game_nb;
    pgn_t pgn[1];
+
+   ASSERT(file_name!=NULL);
+
+   // scan loop
+
+   start = now_real();
+
+   book_clear(Book);
+
+   pgn_open(pgn,file_name);
+   game_nb = insert_games(Book,pgn,true);
+   pgn_close(pgn);
+
+   time = now_real() - start;
+
+   printf("%d game%s in %.1f seconds (%.0f games/s).\n",game_nb,(game_nb>1)?"s":"",time,(time>0.0)?double(game_nb)/time:0.0);
+   printf("%d entries.\n",Book->size);
+}
+
+// book_insert_mt()
+
+static bool book_insert_mt(const char file_name[]) {
+
+   double start, time;
+   int fd;
+   struct stat file_stat;
+   char * data;
+   sint64 size;
+   sint64 begin, end;
+   int line;
+   int game_nb;
+   worker_t * worker;
+   char string[256];
+   int i;
+
+   ASSERT(file_name!=NULL);
+   ASSERT(ThreadNb>1);
+
+   // map the PGN file, false => use book_insert() instead
+
+   start = now_real();
+
+   fd = open(file_name,O_RDONLY);
+   if (fd == -1) my_fatal("book_insert_mt(): can't open file \"%s\": %s\n",file_name,strerror(errno));
+
+   if (fstat(fd,&file_stat) == -1 || file_stat.st_size == 0) {
+      close(fd);
+      return false;
+   }
+
+   size = file_stat.st_size;
+
+   data = (char *) mmap(NULL,size_t(size),PROT_READ,MAP_PRIVATE,fd,0);
+   close(fd);
+
+   if (data == MAP_FAILED) return false;
+
+   madvise(data,size_t(size),MADV_SEQUENTIAL);
+
+   // split the file into one slice of whole games per thread, each filling its own table
+
+   worker = (worker_t *) my_malloc(ThreadNb*sizeof(worker_t));
+
+   begin = 0;
+   line = 1;
+
+   for (i = 0; i < ThreadNb; i++) {
+
+      end = (i == ThreadNb-1) ? size : game_start(data,size,begin,size/ThreadNb*(i+1));
+
+      worker[i].data = data + begin;
+      worker[i].size = end - begin;
+      worker[i].line = line;
+      worker[i].game_nb = 0;
+      worker[i].error = false;
+
+      book_clear(worker[i].book);
+
+      if (pthread_create(&worker[i].thread,NULL,&insert_worker,&worker[i]) != 0) {
+         my_fatal("book_insert_mt(): pthread_create(): %s\n",strerror(errno));
+      }
+
+      line += line_count(worker[i].data,worker[i].size);
+      begin = end;
+   }
+
+   for (i = 0; i < ThreadNb; i++) {
+      pthread_join(worker[i].thread,NULL);
+   }
+
+   // report the first error in file order, before anything is merged or saved
+
+   string[0] = '\0';
+
+   for (i = ThreadNb-1; i >= 0; i--) {
+      if (worker[i].error) strcpy(string,worker[i].trap->string);
+   }
+
+   if (string[0] != '\0') {
+
+      for (i = 0; i < ThreadNb; i++) book_free(worker[i].book);
+      my_free(worker);
+      munmap(data,size_t(size));
+
+      InsertError = true;
+      my_fatal("%s",string);
+
+      return true;
+   }
+
+   // merge the tables in file order, so that entries are created in the same order as book_insert()
+
+   game_nb = 0;
+
+   for (i = 0; i < ThreadNb; i++) {
+
+      game_nb += worker[i].game_nb;
+
+      if (i == 0) {
+         *Book = *worker[i].book;
+      } else {
+         merge_table(Book,worker[i].book);
+         book_free(worker[i].book);
+      }
+   }
+
+   my_free(worker);
+   munmap(data,size_t(size));
+
+   time = now_real() - start;
+
+   printf("%d game%s in %.1f seconds (%.0f games/s, %d threads).\n",game_nb,(game_nb>1)?"s":"",time,(time>0.0)?double(game_nb)/time:0.0,ThreadNb);
+   printf("%d entries.\n",Book->size);
+
+   return true;
+}
+
+// insert_worker()
+
+static void * insert_worker(void * arg) {
+
+   worker_t * worker;
+   pgn_t pgn[1];
+
+   worker = (worker_t *) arg;
+
+   // a my_fatal() here would only end this thread, so record the error instead
+
+   my_fatal_trap(worker->trap);
+
+   if (setjmp(worker->trap->buf) == 0) {
+      pgn_open_buffer(pgn,worker->data,worker->size,worker->line);
+      worker->game_nb = insert_games(worker->book,pgn,false);
+      pgn_close(pgn);
+   } else {
+      worker->error = true;
+   }
+
+   my_fatal_trap(NULL);
+
+   return NULL;
+}
+
+// insert_games()
+
+static int insert_games(book_t * book, pgn_t * pgn, bool disp) {
+
+   int game_nb;
    board_t board[1];
    int ply;
    int result;
@@ -232,7 +506,8 @@ static void book_insert(const char file_name[]) {
    int move;
    int pos;
 
-   ASSERT(file_name!=NULL);
+   ASSERT(book!=NULL);
+   ASSERT(pgn!=NULL);
 
    // init
 
@@ -240,8 +515,6 @@ static void book_insert(const char file_name[]) {
 
    // scan loop
 
-   pgn_open(pgn,file_name);
-
    while (pgn_next_game(pgn)) {
 
       board_start(board);
@@ -265,13 +538,13 @@ static void book_insert(const char file_name[]) {
                my_fatal("book_insert(): illegal move \"%s\" at line %d, column %d\n",string,pgn->move_line,pgn->move_column);
             }
 
-            pos = find_entry(board,move);
+            pos = find_entry(book,board->key,move,board->turn);
 
-            Book->entry[pos].n++;
-            Book->entry[pos].sum += result+1;
+            book->entry[pos].n++;
+            book->entry[pos].sum += result+1;
 
-            if (Book->entry[pos].n >= COUNT_MAX) {
-               halve_stats(board->key);
+            if (book->entry[pos].n >= COUNT_MAX) {
+               halve_stats(book,board->key);
             }
 
             move_do(board,move);
@@ -281,15 +554,49 @@ static void book_insert(const char file_name[]) {
       }
 
       game_nb++;
-      if (game_nb % 10000 == 0) printf("%d games ...\n",game_nb);
+      if (disp && game_nb % 10000 == 0) printf("%d games ...\n",game_nb);
    }
 
-   pgn_close(pgn);
+   return game_nb;
+}
 
-   printf("%d game%s.\n",game_nb,(game_nb>1)?"s":"");
-   printf("%d entries.\n",Book->size);
+// merge_table()
+
+static void merge_table(book_t * dst, const book_t * src) {
+
+   int src_pos, dst_pos;
+   const entry_t * entry;
+
+   ASSERT(dst!=NULL);
+   ASSERT(src!=NULL);
+
+   // add the partial counts (both below COUNT_MAX, so no overflow)
+
+   for (src_pos = 0; src_pos < src->size; src_pos++) {
+
+      entry = &src->entry[src_pos];
+
+      dst_pos = find_entry(dst,entry->key,entry->move,entry->colour);
 
-   return;
+      ASSERT(dst->entry[dst_pos].n<COUNT_MAX&&entry->n<COUNT_MAX);
+      dst->entry[dst_pos].n += entry->n;
+      dst->entry[dst_pos].sum += entry->sum;
+   }
+
+   // then halve as insert_games() does, once all the moves of a position are added
+
+   for (src_pos = 0; src_pos < src->size; src_pos++) {
+
+      entry = &src->entry[src_pos];
+
+      dst_pos = find_entry(dst,entry->key,entry->move,entry->colour);
+
+      if (dst->entry[dst_pos].n >= COUNT_MAX) {
+         halve_stats(dst,entry->key);
+      }
+
+      ASSERT(dst->entry[dst_pos].n<COUNT_MAX);
+   }
 }
 
 // book_filter()
@@ -351,126 +658,227 @@ static void book_save(const char file_name[]) {
 
 // find_entry()
 
-static int find_entry(const board_t * board, int move) {
+static int find_entry(book_t * book, uint64 key, int move, int colour) {
 
-   uint64 key;
    int index;
    int pos;
 
-   ASSERT(board!=NULL);
+   ASSERT(book!=NULL);
    ASSERT(move_is_ok(move));
 
-   ASSERT(move_is_legal(move,board));
-
-   // init
-
-   key = board->key;
-
    // search
 
-   for (index = key & Book->mask; (pos=Book->hash[index]) != NIL; index = (index+1) & Book->mask) {
+   for (index = key & book->mask; (pos=book->hash[index]) != NIL; index = (index+1) & book->mask) {
 
-      ASSERT(pos>=0&&pos<Book->size);
+      ASSERT(pos>=0&&pos<book->size);
 
-      if (Book->entry[pos].key == key && Book->entry[pos].move == move) {
+      if (book->entry[pos].key == key && book->entry[pos].move == move) {
          return pos; // found
       }
    }
 
    // not found
 
-   ASSERT(Book->size<=Book->alloc);
+   ASSERT(book->size<=book->alloc);
 
-   if (Book->size == Book->alloc) {
+   if (book->size == book->alloc) {
 
       // allocate more memory
 
-      resize();
+      resize(book);
 
-      for (index = key & Book->mask; Book->hash[index] != NIL; index = (index+1) & Book->mask)
+      for (index = key & book->mask; book->hash[index] != NIL; index = (index+1) & book->mask)
          ;
    }
 
    // create a new entry
 
-   ASSERT(Book->size<Book->alloc);
-   pos = Book->size++;
+   ASSERT(book->size<book->alloc);
+   pos = book->size++;
 
-   Book->entry[pos].key = key;
-   Book->entry[pos].move = move;
-   Book->entry[pos].n = 0;
-   Book->entry[pos].sum = 0;
-   Book->entry[pos].colour = board->turn;
+   book->entry[pos].key = key;
+   book->entry[pos].move = move;
+   book->entry[pos].n = 0;
+   book->entry[pos].sum = 0;
+   book->entry[pos].colour = colour;
 
    // insert into the hash table
 
-   ASSERT(index>=0&&index<Book->alloc*2);
-   ASSERT(Book->hash[index]==NIL);
-   Book->hash[index] = pos;
+   ASSERT(index>=0&&index<book->alloc*2);
+   ASSERT(book->hash[index]==NIL);
+   book->hash[index] = pos;
 
-   ASSERT(pos>=0&&pos<Book->size);
+   ASSERT(pos>=0&&pos<book->size);
 
    return pos;
 }
 
 // resize()
 
-static void resize() {
+static void resize(book_t * book) {
 
    int size;
    int pos;
    int index;
 
-   ASSERT(Book->size==Book->alloc);
+   ASSERT(book!=NULL);
+   ASSERT(book->size==book->alloc);
 
-   Book->alloc *= 2;
-   Book->mask = (Book->alloc * 2) - 1;
+   book->alloc *= 2;
+   book->mask = (book->alloc * 2) - 1;
 
    size = 0;
-   size += Book->alloc * sizeof(entry_t);
-   size += (Book->alloc*2) * sizeof(sint32);
+   size += book->alloc * sizeof(entry_t);
+   size += (book->alloc*2) * sizeof(sint32);
 
-   if (size >= 1048576) printf("allocating %gMB ...\n",double(size)/1048576.0);
+   if (size >= 1048576 && book == Book) printf("allocating %gMB ...\n",double(size)/1048576.0);
 
    // resize arrays
 
-   Book->entry = (entry_t *) my_realloc(Book->entry,Book->alloc*sizeof(entry_t));
-   Book->hash = (sint32 *) my_realloc(Book->hash,(Book->alloc*2)*sizeof(sint32));
+   book->entry = (entry_t *) my_realloc(book->entry,book->alloc*sizeof(entry_t));
+   book->hash = (sint32 *) my_realloc(book->hash,(book->alloc*2)*sizeof(sint32));
 
    // rebuild hash table
 
-   for (index = 0; index < Book->alloc*2; index++) {
-      Book->hash[index] = NIL;
+   for (index = 0; index < book->alloc*2; index++) {
+      book->hash[index] = NIL;
    }
 
-   for (pos = 0; pos < Book->size; pos++) {
+   for (pos = 0; pos < book->size; pos++) {
 
-      for (index = Book->entry[pos].key & Book->mask; Book->hash[index] != NIL; index = (index+1) & Book->mask)
+      for (index = book->entry[pos].key & book->mask; book->hash[index] != NIL; index = (index+1) & book->mask)
          ;
 
-      ASSERT(index>=0&&index<Book->alloc*2);
-      Book->hash[index] = pos;
+      ASSERT(index>=0&&index<book->alloc*2);
+      book->hash[index] = pos;
    }
 }
 
 // halve_stats()
 
-static void halve_stats(uint64 key) {
+static void halve_stats(book_t * book, uint64 key) {
 
    int index;
    int pos;
 
+   ASSERT(book!=NULL);
+
    // search
 
-   for (index = key & Book->mask; (pos=Book->hash[index]) != NIL; index = (index+1) & Book->mask) {
+   for (index = key & book->mask; (pos=book->hash[index]) != NIL; index = (index+1) & book->mask) {
+
+      ASSERT(pos>=0&&pos<book->size);
+
+      if (book->entry[pos].key == key) {
+         book->entry[pos].n = (book->entry[pos].n + 1) / 2;
+         book->entry[pos].sum = (book->entry[pos].sum + 1) / 2;
+      }
+   }
+}
+
+// game_start()
+
+static sint64 game_start(const char data[], sint64 size, sint64 begin, sint64 pos) {
+
+   bool tag, prev_tag;
+   const char * ptr;
+   char c;
+
+   ASSERT(data!=NULL);
+   ASSERT(begin>=0&&begin<=size);
+   ASSERT(pos>=0&&pos<=size);
+
+   // first line at or after "pos" that starts a tag section (a "[" line after a non-tag line),
+   // scanning from "begin" (a game start) and skipping comments and strings as pgn.cpp does,
+   // so that a "[" line inside a multi-line comment is never taken for a tag
+
+   prev_tag = true; // do not split at "begin"
+
+   while (begin < size) {
+
+      // at the start of a line, outside any comment or string
+
+      tag = data[begin] == '[';
+      if (tag && !prev_tag && begin >= pos) return begin;
+
+      prev_tag = tag;
+
+      if (data[begin] == '%') { // escape line, comment to EOL
+
+         ptr = (const char *) memchr(&data[begin],'\n',size-begin);
+         if (ptr == NULL) return size;
+
+         begin = ptr - data + 1;
+         continue;
+      }
+
+      // scan to the start of the next line
+
+      while (begin < size) {
+
+         c = data[begin++];
 
-      ASSERT(pos>=0&&pos<Book->size);
+         if (false) {
 
-      if (Book->entry[pos].key == key) {
-         Book->entry[pos].n = (Book->entry[pos].n + 1) / 2;
-         Book->entry[pos].sum = (Book->entry[pos].sum + 1) / 2;
+         } else if (c == '\n') {
+
+            break;
+
+         } else if (c == ';') {
+
+            // comment to EOL
+
+            ptr = (const char *) memchr(&data[begin],'\n',size-begin);
+            if (ptr == NULL) return size;
+
+            begin = ptr - data + 1;
+            break;
+
+         } else if (c == '{') {
+
+            // comment to next '}'
+
+            ptr = (const char *) memchr(&data[begin],'}',size-begin);
+            if (ptr == NULL) return size; // EOF in comment, reported by the last slice
+
+            begin = ptr - data + 1;
+
+         } else if (c == '"') {
+
+            // string, with escapes
+
+            while (begin < size && data[begin] != '"') {
+               if (data[begin] == '\\') begin++;
+               begin++;
+            }
+
+            if (begin >= size) return size; // EOF in string, reported by the last slice
+
+            begin++;
+         }
       }
    }
+
+   return size;
+}
+
+// line_count()
+
+static int line_count(const char data[], sint64 size) {
+
+   const char * ptr, * end;
+   int line_nb;
+
+   ASSERT(data!=NULL);
+   ASSERT(size>=0);
+
+   line_nb = 0;
+
+   for (ptr = data, end = data + size; (ptr = (const char *) memchr(ptr,'\n',end-ptr)) != NULL; ptr++) {
+      line_nb++;
+   }
+
+   return line_nb;
 }
 
 // keep_entry()
@@ -34,6 +34,7 @@
 
 #include "io.h"
 #include "util.h"
+#include "components.h"
 
 namespace adapter {
 
@@ -94,7 +95,7 @@ void io_close(io_t * io) {
 
    my_log("> %s EOF\n",io->name);
 
-   if (close(io->out_fd) == -1) {
+   if (ChannelClose(io->out_fd) == -1) {
       my_fatal("io_close(): close(): %s\n",strerror(errno));
    }
 
@@ -304,7 +305,7 @@ static int my_read(int fd, char string[], int size) {
    ASSERT(size>0);
 
    do {
-      n = read(fd,string,size);
+      n = ChannelRead(fd,string,size);
    } while (n == -1 && errno == EINTR);
 
    if (n == -1) my_fatal("my_read(): read(): %s\n",strerror(errno));
@@ -326,7 +327,7 @@ static void my_write(int fd, const char string[], int size) {
 
    do {
 
-      n = write(fd,string,size);
+      n = ChannelWrite(fd,string,size);
 
       // if (n == -1 && errno != EINTR && errno != EPIPE) my_fatal("my_write(): write(): %s\n",strerror(errno));
 
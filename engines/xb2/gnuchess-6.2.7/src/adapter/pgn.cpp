@@ -28,6 +28,12 @@
 #include <cstdio>
 #include <cstring>
 
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 #include "pgn.h"
 #include "util.h"
 
@@ -43,6 +49,8 @@ static const int TAB_SIZE = 8;
 
 static const int CHAR_EOF = 256;
 
+static const int BlockSize = 1 << 20; // read() size when the file cannot be mapped
+
 // types
 
 enum token_t {
@@ -57,6 +65,8 @@ enum token_t {
 
 // prototypes
 
+static void pgn_init         (pgn_t * pgn, int line);
+
 static void pgn_token_read   (pgn_t * pgn);
 static void pgn_token_unread (pgn_t * pgn);
 
@@ -64,11 +74,13 @@ static void pgn_read_token   (pgn_t * pgn);
 
 static bool is_symbol_start  (int c);
 static bool is_symbol_next   (int c);
+static bool is_blank         (int c);
 
 static void pgn_skip_blanks  (pgn_t * pgn);
 
 static void pgn_char_read    (pgn_t * pgn);
 static void pgn_char_unread  (pgn_t * pgn);
+static void pgn_char_skip    (pgn_t * pgn, const char * ptr);
 
 // functions
 
@@ -76,14 +88,96 @@ static void pgn_char_unread  (pgn_t * pgn);
 
 void pgn_open(pgn_t * pgn, const char file_name[]) {
 
+   int fd;
+   struct stat file_stat;
+   int alloc;
+   int size;
+   int n;
+
    ASSERT(pgn!=NULL);
    ASSERT(file_name!=NULL);
 
-   pgn->file = fopen(file_name,"r");
-   if (pgn->file == NULL) my_fatal("pgn_open(): can't open file \"%s\": %s\n",file_name,strerror(errno));
+   fd = open(file_name,O_RDONLY);
+   if (fd == -1) my_fatal("pgn_open(): can't open file \"%s\": %s\n",file_name,strerror(errno));
+
+   // map the whole file, the tokeniser scans it in place
+
+   pgn->data = NULL;
+   pgn->data_size = 0;
+   pgn->data_mapped = false;
+
+   if (fstat(fd,&file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0) {
+
+      pgn->data = (char *) mmap(NULL,size_t(file_stat.st_size),PROT_READ,MAP_PRIVATE,fd,0);
+
+      if (pgn->data != MAP_FAILED) {
+         pgn->data_size = file_stat.st_size;
+         pgn->data_mapped = true;
+         madvise(pgn->data,size_t(pgn->data_size),MADV_SEQUENTIAL);
+      } else {
+         pgn->data = NULL;
+      }
+   }
+
+   if (!pgn->data_mapped) { // HACK: empty file, pipe, ... read it all in large blocks
+
+      alloc = 0;
+      size = 0;
+
+      while (true) {
+
+         if (size == alloc) {
+            alloc += BlockSize;
+            pgn->data = (char *) my_realloc(pgn->data,alloc);
+         }
+
+         n = read(fd,pgn->data+size,alloc-size);
+         if (n == -1) my_fatal("pgn_open(): read(): %s\n",strerror(errno));
+         if (n == 0) break;
+
+         size += n;
+      }
+
+      pgn->data_size = size;
+   }
+
+   close(fd);
+
+   pgn->buffer_ptr = pgn->data;
+   pgn->buffer_end = pgn->data + pgn->data_size;
+
+   pgn_init(pgn,1);
+}
+
+// pgn_open_buffer()
+
+void pgn_open_buffer(pgn_t * pgn, const char buffer[], sint64 size, int line) {
+
+   ASSERT(pgn!=NULL);
+   ASSERT(buffer!=NULL);
+   ASSERT(size>=0);
+   ASSERT(line>=1);
+
+   // games in memory, e.g. a slice of a mapped file (line numbers start at "line")
+
+   pgn->data = NULL;
+   pgn->data_size = 0;
+   pgn->data_mapped = false;
+
+   pgn->buffer_ptr = buffer;
+   pgn->buffer_end = buffer + size;
+
+   pgn_init(pgn,line);
+}
+
+// pgn_init()
+
+static void pgn_init(pgn_t * pgn, int line) {
+
+   ASSERT(pgn!=NULL);
 
    pgn->char_hack = CHAR_EOF; // DEBUG
-   pgn->char_line = 1;
+   pgn->char_line = line;
    pgn->char_column = 0;
    pgn->char_unread = false;
    pgn->char_first = true;
@@ -109,7 +203,13 @@ void pgn_close(pgn_t * pgn) {
 
    ASSERT(pgn!=NULL);
 
-   fclose(pgn->file);
+   if (pgn->data_mapped) {
+      munmap(pgn->data,size_t(pgn->data_size));
+   } else if (pgn->data != NULL) {
+      my_free(pgn->data);
+   }
+
+   pgn->data = NULL;
 }
 
 // pgn_next_game()
@@ -327,6 +427,9 @@ static void pgn_token_unread(pgn_t * pgn) {
 
 static void pgn_read_token(pgn_t * pgn) {
 
+   const char * start, * ptr;
+   int room;
+
    ASSERT(pgn!=NULL);
 
    // skip white-space characters
@@ -336,7 +439,7 @@ static void pgn_read_token(pgn_t * pgn) {
    // init
 
    pgn->token_type = TOKEN_ERROR;
-   strcpy(pgn->token_string,"");
+   pgn->token_string[0] = '\0';
    pgn->token_length = 0;
    pgn->token_line = pgn->char_line;
    pgn->token_column = pgn->char_column;
@@ -349,18 +452,54 @@ static void pgn_read_token(pgn_t * pgn) {
 
       pgn->token_type = TOKEN_EOF;
 
+   } else if (is_symbol_start(pgn->char_hack)) {
+
+      // symbol, integer, or result (most tokens, tested first), scanned in the buffer (no tab or newline inside)
+
+      pgn->token_type = TOKEN_INTEGER;
+
+      start = pgn->buffer_ptr - 1;
+      ASSERT(*start==pgn->char_hack);
+
+      for (ptr = start; ptr < pgn->buffer_end && is_symbol_next((unsigned char)*ptr); ptr++) {
+         if (!isdigit((unsigned char)*ptr)) pgn->token_type = TOKEN_SYMBOL;
+      }
+
+      pgn->token_length = ptr - start;
+
+      if (pgn->token_length >= PGN_STRING_SIZE) {
+         my_fatal("pgn_read_token(): symbol too long at line %d, column %d\n",pgn->char_line,pgn->char_column+PGN_STRING_SIZE-1);
+      }
+
+      memcpy(pgn->token_string,start,pgn->token_length);
+
+      pgn_char_skip(pgn,ptr);
+      pgn_char_unread(pgn);
+
+      ASSERT(pgn->token_length>0&&pgn->token_length<PGN_STRING_SIZE);
+      pgn->token_string[pgn->token_length] = '\0';
+
+      if (pgn->token_type == TOKEN_SYMBOL && (pgn->token_string[0] == '0' || pgn->token_string[0] == '1') // quick test first
+       && (my_string_equal(pgn->token_string,"1-0")
+        || my_string_equal(pgn->token_string,"0-1")
+        || my_string_equal(pgn->token_string,"1/2-1/2"))) {
+         pgn->token_type = TOKEN_RESULT;
+      }
+
    } else if (strchr(".[]()<>",pgn->char_hack) != NULL) {
 
       // single-character token
 
       pgn->token_type = pgn->char_hack;
-      sprintf(pgn->token_string,"%c",pgn->char_hack);
+      pgn->token_string[0] = pgn->char_hack;
+      pgn->token_string[1] = '\0';
       pgn->token_length = 1;
 
    } else if (pgn->char_hack == '*') {
 
       pgn->token_type = TOKEN_RESULT;
-      sprintf(pgn->token_string,"%c",pgn->char_hack);
+      pgn->token_string[0] = pgn->char_hack;
+      pgn->token_string[1] = '\0';
       pgn->token_length = 1;
 
    } else if (pgn->char_hack == '!') {
@@ -417,38 +556,6 @@ static void pgn_read_token(pgn_t * pgn) {
          pgn->token_length = 1;
       }
 
-   } else if (is_symbol_start(pgn->char_hack)) {
-
-      // symbol, integer, or result
-
-      pgn->token_type = TOKEN_INTEGER;
-      pgn->token_length = 0;
-
-      do {
-
-         if (pgn->token_length >= PGN_STRING_SIZE-1) {
-            my_fatal("pgn_read_token(): symbol too long at line %d, column %d\n",pgn->char_line,pgn->char_column);
-         }
-
-         if (!isdigit(pgn->char_hack)) pgn->token_type = TOKEN_SYMBOL;
-
-         pgn->token_string[pgn->token_length++] = pgn->char_hack;
-
-         pgn_char_read(pgn);
-
-      } while (is_symbol_next(pgn->char_hack));
-
-      pgn_char_unread(pgn);
-
-      ASSERT(pgn->token_length>0&&pgn->token_length<PGN_STRING_SIZE);
-      pgn->token_string[pgn->token_length] = '\0';
-
-      if (my_string_equal(pgn->token_string,"1-0")
-       || my_string_equal(pgn->token_string,"0-1")
-       || my_string_equal(pgn->token_string,"1/2-1/2")) {
-         pgn->token_type = TOKEN_RESULT;
-      }
-
    } else if (pgn->char_hack == '"') {
 
       // string
@@ -458,6 +565,19 @@ static void pgn_read_token(pgn_t * pgn) {
 
       while (true) {
 
+         // plain characters are copied straight from the buffer
+
+         room = PGN_STRING_SIZE-1 - pgn->token_length;
+
+         for (ptr = pgn->buffer_ptr; ptr < pgn->buffer_end && *ptr != '"' && *ptr != '\\' && ptr - pgn->buffer_ptr < room; ptr++)
+            ;
+
+         if (ptr > pgn->buffer_ptr) {
+            memcpy(&pgn->token_string[pgn->token_length],pgn->buffer_ptr,ptr-pgn->buffer_ptr);
+            pgn->token_length += ptr - pgn->buffer_ptr;
+            pgn_char_skip(pgn,ptr-1);
+         }
+
          pgn_char_read(pgn);
 
          if (pgn->char_hack == CHAR_EOF) {
@@ -537,6 +657,8 @@ static void pgn_read_token(pgn_t * pgn) {
 
 static void pgn_skip_blanks(pgn_t * pgn) {
 
+   const char * ptr;
+
    ASSERT(pgn!=NULL);
 
    while (true) {
@@ -545,51 +667,36 @@ static void pgn_skip_blanks(pgn_t * pgn) {
 
       if (false) {
 
-      } else if (isspace(pgn->char_hack)) {
-
-         // skip white space
-
-      } else if (pgn->char_hack == ';') {
+      } else if (is_blank(pgn->char_hack)) {
 
-         // skip comment to EOL
-
-         do {
-
-            pgn_char_read(pgn);
+         // skip white space, up to the last blank character
 
-            if (pgn->char_hack == CHAR_EOF) {
-               my_fatal("pgn_skip_blanks(): EOF in comment at line %d, column %d\n",pgn->char_line,pgn->char_column);
-            }
+         for (ptr = pgn->buffer_ptr; ptr < pgn->buffer_end && is_blank((unsigned char)*ptr); ptr++)
+            ;
 
-         } while (pgn->char_hack != '\n');
+         pgn_char_skip(pgn,ptr-1);
 
-      } else if (pgn->char_hack == '%' && pgn->char_column == 0) {
+      } else if (pgn->char_hack == ';' || (pgn->char_hack == '%' && pgn->char_column == 0)) {
 
          // skip comment to EOL
 
-         do {
+         ptr = (const char *) memchr(pgn->buffer_ptr,'\n',pgn->buffer_end-pgn->buffer_ptr);
+         pgn_char_skip(pgn,(ptr!=NULL)?ptr:pgn->buffer_end);
 
-            pgn_char_read(pgn);
-
-            if (pgn->char_hack == CHAR_EOF) {
-               my_fatal("pgn_skip_blanks(): EOF in comment at line %d, column %d\n",pgn->char_line,pgn->char_column);
-            }
-
-         } while (pgn->char_hack != '\n');
+         if (pgn->char_hack == CHAR_EOF) {
+            my_fatal("pgn_skip_blanks(): EOF in comment at line %d, column %d\n",pgn->char_line,pgn->char_column);
+         }
 
       } else if (pgn->char_hack == '{') {
 
          // skip comment to next '}'
 
-         do {
+         ptr = (const char *) memchr(pgn->buffer_ptr,'}',pgn->buffer_end-pgn->buffer_ptr);
+         pgn_char_skip(pgn,(ptr!=NULL)?ptr:pgn->buffer_end);
 
-            pgn_char_read(pgn);
-
-            if (pgn->char_hack == CHAR_EOF) {
-               my_fatal("pgn_skip_blanks(): EOF in comment at line %d, column %d\n",pgn->char_line,pgn->char_column);
-            }
-
-         } while (pgn->char_hack != '}');
+         if (pgn->char_hack == CHAR_EOF) {
+            my_fatal("pgn_skip_blanks(): EOF in comment at line %d, column %d\n",pgn->char_line,pgn->char_column);
+         }
 
       } else { // not a white space
 
@@ -602,14 +709,21 @@ static void pgn_skip_blanks(pgn_t * pgn) {
 
 static bool is_symbol_start(int c) {
 
-   return strchr("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",c) != NULL;
+   return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
 }
 
 // is_symbol_next()
 
 static bool is_symbol_next(int c) {
 
-   return strchr("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_+#=:-/",c) != NULL;
+   return is_symbol_start(c) || c == '_' || c == '+' || c == '#' || c == '=' || c == ':' || c == '-' || c == '/';
+}
+
+// is_blank()
+
+static bool is_blank(int c) {
+
+   return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v'; // isspace() in the "C" locale
 }
 
 // pgn_char_read()
@@ -650,11 +764,10 @@ static void pgn_char_read(pgn_t * pgn) {
 
    // read a new character
 
-   pgn->char_hack = fgetc(pgn->file);
-
-   if (pgn->char_hack == EOF) {
-      if (ferror(pgn->file)) my_fatal("pgn_char_read(): fgetc(): %s\n",strerror(errno));
-      pgn->char_hack = TOKEN_EOF;
+   if (pgn->buffer_ptr < pgn->buffer_end) {
+      pgn->char_hack = (unsigned char) *pgn->buffer_ptr++;
+   } else {
+      pgn->char_hack = CHAR_EOF;
    }
 
    if (DispChar) printf("< L%d C%d '%c' (%02X)\n",pgn->char_line,pgn->char_column,pgn->char_hack,pgn->char_hack);
@@ -672,6 +785,42 @@ static void pgn_char_unread(pgn_t * pgn) {
    pgn->char_unread = true;
 }
 
+// pgn_char_skip()
+
+static void pgn_char_skip(pgn_t * pgn, const char * ptr) {
+
+   const char * p;
+
+   ASSERT(pgn!=NULL);
+   ASSERT(!pgn->char_unread);
+   ASSERT(!pgn->char_first);
+   ASSERT(pgn->char_hack!=CHAR_EOF);
+   ASSERT(ptr>=pgn->buffer_ptr-1&&ptr<=pgn->buffer_end);
+
+   // same as calling pgn_char_read() until "ptr" is the current character (CHAR_EOF at the end)
+
+   for (p = pgn->buffer_ptr - 1; p < ptr; p++) {
+
+      if (false) {
+      } else if (*p == '\n') {
+         pgn->char_line++;
+         pgn->char_column = 0;
+      } else if (*p == '\t') {
+         pgn->char_column += TAB_SIZE - (pgn->char_column % TAB_SIZE);
+      } else {
+         pgn->char_column++;
+      }
+   }
+
+   if (ptr < pgn->buffer_end) {
+      pgn->char_hack = (unsigned char) *ptr;
+      pgn->buffer_ptr = ptr + 1;
+   } else {
+      pgn->char_hack = CHAR_EOF;
+      pgn->buffer_ptr = pgn->buffer_end;
+   }
+}
+
 }  // namespace adapter
 
 // end of pgn.cpp
@@ -40,7 +40,12 @@ const int PGN_STRING_SIZE = 256;
 
 struct pgn_t {
 
-   FILE * file;
+   char * data; // pgn_open() file contents, mapped or read, NULL for pgn_open_buffer()
+   sint64 data_size;
+   bool data_mapped;
+
+   const char * buffer_ptr; // next character
+   const char * buffer_end;
 
    int char_hack;
    int char_line;
@@ -65,11 +70,12 @@ struct pgn_t {
 
 // functions
 
-extern void pgn_open      (pgn_t * pgn, const char file_name[]);
-extern void pgn_close     (pgn_t * pgn);
+extern void pgn_open        (pgn_t * pgn, const char file_name[]);
+extern void pgn_open_buffer (pgn_t * pgn, const char buffer[], sint64 size, int line);
+extern void pgn_close       (pgn_t * pgn);
 
-extern bool pgn_next_game (pgn_t * pgn);
-extern bool pgn_next_move (pgn_t * pgn, char string[], int size);
+extern bool pgn_next_game   (pgn_t * pgn);
+extern bool pgn_next_move   (pgn_t * pgn, char string[], int size);
 
 }  // namespace adapter
 
@@ -47,6 +47,8 @@ const int MaxFileNameSize = 256;
 
 static bool Error;
 
+static thread_local my_trap_t * FatalTrap; // set by threads that report their errors themselves
+
 static FILE * LogFile;
 
 // functions
@@ -195,6 +197,15 @@ void my_fatal(const char format[], ...) {
 
    ASSERT(format!=NULL);
 
+   if (FatalTrap != NULL) { // keep the message and return to the thread's setjmp()
+
+      va_start(ap,format);
+      vsnprintf(FatalTrap->string,sizeof(FatalTrap->string),format,ap);
+      va_end(ap);
+
+      longjmp(FatalTrap->buf,1);
+   }
+
    va_start(ap,format);
 
    vfprintf(stderr,format,ap);
@@ -212,6 +223,15 @@ void my_fatal(const char format[], ...) {
    }
 }
 
+// my_fatal_trap()
+
+void my_fatal_trap(my_trap_t * trap) {
+
+   // NULL => my_fatal() quits as usual
+
+   FatalTrap = trap;
+}
+
 // my_file_read_line()
 
 bool my_file_read_line(FILE * file, char string[], int size) {
@@ -26,6 +26,7 @@
 
 // includes
 
+#include <csetjmp>
 #include <cstdio>
 
 // constants
@@ -93,6 +94,11 @@ typedef unsigned int uint32;
   typedef unsigned long long int uint64;
 #endif
 
+struct my_trap_t {
+   jmp_buf buf;
+   char string[256];
+};
+
 struct my_timer_t {
    double start_real;
    double start_cpu;
@@ -122,6 +128,7 @@ extern void   my_log_close          ();
 
 extern void   my_log                (const char format[], ...);
 extern void   my_fatal              (const char format[], ...);
+extern void   my_fatal_trap         (my_trap_t * trap);
 
 extern bool   my_file_read_line     (FILE * file, char string[], int size);
 
@@ -23,12 +23,22 @@
      cracraft@ai.mit.edu, cracraft@stanfordalumni.org, cracraft@earthlink.net
 */
 
+#include <atomic>
+#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include <unistd.h>
 #include <pthread.h>
 #include <signal.h>
+#include <sys/select.h>
+
+#if defined(__linux__) && defined(__GLIBC__)
+#  include <stdint.h>
+#  include <sys/eventfd.h>
+#  define HAVE_CHANNELS 1
+#endif
 
 #include "frontend/common.h"
 #include "components.h"
@@ -66,6 +76,35 @@ int pipefd_a2f[2];
 int pipefd_a2e[2];
 int pipefd_e2a[2];
 
+/*
+ * Transport between frontend, adapter and engine: in-process ring buffers
+ * (true) or kernel pipes (false). A ring buffer costs no system call while
+ * its consumer is awake, and the engine polls its input during the search
+ * with a memory read instead of a select().
+ */
+#ifdef HAVE_CHANNELS
+static const bool UseChannels = true;
+#else
+static const bool UseChannels = false; /* needs eventfd() and fopencookie() */
+#endif
+
+/* Ring buffer size of a channel, a power of two */
+static const size_t ChannelSize = 1 << 20;
+static const int ChannelMax = 8;
+
+typedef struct {
+  int fd;                       /* eventfd, also the handle of the channel */
+  char *data;
+  std::atomic<size_t> head;     /* bytes written so far, by the producer */
+  std::atomic<size_t> tail;     /* bytes read so far, by the consumer */
+  std::atomic<bool> waiting;    /* the consumer is going to sleep on fd */
+  std::atomic<bool> closed;     /* the producer has closed the channel */
+} channel_t;
+
+static channel_t channels[ChannelMax];
+static std::atomic<int> channel_count( 0 );
+static pthread_mutex_t channel_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 /*
  * Entry point for the input thread
  */
@@ -108,7 +147,7 @@ void *adapter_func(void *arg)
 void InitAdapter()
 {
   /* Create pipes to communicate frontend and adapter. */
-  if ( ( pipe( pipefd_f2a ) != 0 ) || ( pipe( pipefd_a2f ) != 0 ) ) {
+  if ( ( CreateChannel( pipefd_f2a ) != 0 ) || ( CreateChannel( pipefd_a2f ) != 0 ) ) {
     printf( "Error while creating pipes.\n" );
     exit( 1 );
   }
@@ -145,7 +184,7 @@ void *engine_func(void *arg)
 void InitEngine()
 {
   /* Create pipes to communicate adapter and engine. */
-  if ( ( pipe( pipefd_a2e ) != 0 ) || ( pipe( pipefd_e2a ) != 0 ) ) {
+  if ( ( CreateChannel( pipefd_a2e ) != 0 ) || ( CreateChannel( pipefd_e2a ) != 0 ) ) {
     printf( "Error while creating pipes.\n" );
     exit( 1 );
   }
@@ -169,8 +208,316 @@ void TerminateAdapterEngine()
   }
 }
 
+/*
+ * Runs commands on the engine alone (no adapter) and copies its output to
+ * stdout until they are all processed, then stops the engine. An "isready"
+ * sent after the commands marks their end, since the engine answers it only
+ * once the previous commands have completed.
+ */
+void RunEngineCommands( const char *commands )
+{
+  char line[BUF_SIZE];
+  FILE *engineout;
+
+  snprintf( line, BUF_SIZE, "%s\nisready\n", commands );
+  if ( ChannelWrite( pipefd_a2e[1], line, strlen( line ) ) != (ssize_t) strlen( line ) ) {
+    printf( "Error sending message to engine.\n" );
+    exit( 1 );
+  }
+
+  engineout = ChannelStream( pipefd_e2a[0], "r" );
+  while ( fgets( line, BUF_SIZE, engineout ) != NULL ) {
+    if ( strcmp( line, "readyok\n" ) == 0 )
+      break;
+    fputs( line, stdout );
+    fflush( stdout );
+  }
+
+  strcpy( line, "quit\n" );
+  if ( ChannelWrite( pipefd_a2e[1], line, strlen( line ) ) == (ssize_t) strlen( line ) )
+    pthread_join( engine_thread, NULL );
+}
+
 void TerminateInput()
 {
   pthread_cancel( input_thread );
   pthread_join( input_thread, NULL );
 }
+
+/*
+ * Returns the channel whose handle is fd, or NULL for a plain descriptor.
+ */
+static channel_t *FindChannel( int fd )
+{
+  int count = channel_count.load( std::memory_order_acquire );
+
+  for ( int i = 0; i < count; i++ ) {
+    if ( channels[i].fd == fd )
+      return &channels[i];
+  }
+  return NULL;
+}
+
+/*
+ * Creates a channel, or a pipe with the pipe transport. Both descriptors of
+ * a channel are its eventfd.
+ */
+int CreateChannel( int fd[2] )
+{
+#ifdef HAVE_CHANNELS
+  if ( UseChannels ) {
+    channel_t *channel;
+    int count;
+
+    pthread_mutex_lock( &channel_mutex );
+    count = channel_count.load( std::memory_order_relaxed );
+    if ( count >= ChannelMax ) {
+      pthread_mutex_unlock( &channel_mutex );
+      errno = EMFILE;
+      return -1;
+    }
+    channel = &channels[count];
+    channel->data = (char *) malloc( ChannelSize );
+    if ( channel->data == NULL ) {
+      pthread_mutex_unlock( &channel_mutex );
+      errno = ENOMEM;
+      return -1;
+    }
+    channel->fd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+    if ( channel->fd == -1 ) {
+      free( channel->data );
+      pthread_mutex_unlock( &channel_mutex );
+      return -1;
+    }
+    channel->head.store( 0 );
+    channel->tail.store( 0 );
+    channel->waiting.store( false );
+    channel->closed.store( false );
+    channel_count.store( count + 1, std::memory_order_release );
+    pthread_mutex_unlock( &channel_mutex );
+
+    fd[0] = fd[1] = channel->fd;
+    return 0;
+  }
+#endif
+  return pipe( fd );
+}
+
+/*
+ * True if reading the channel would not block.
+ */
+static bool ChannelHasInput( channel_t *channel )
+{
+  return channel->head.load( std::memory_order_acquire ) != channel->tail.load( std::memory_order_relaxed )
+      || channel->closed.load( std::memory_order_acquire );
+}
+
+/*
+ * Wakes the consumer up if it is sleeping on the channel. The fence pairs
+ * with the one in PollInput(), so that either the consumer sees the new data
+ * or the producer sees the consumer waiting.
+ */
+static void WakeChannel( channel_t *channel )
+{
+  std::atomic_thread_fence( std::memory_order_seq_cst );
+  if ( channel->waiting.load( std::memory_order_relaxed ) && channel->waiting.exchange( false ) ) {
+    uint64_t one = 1;
+    ssize_t r = write( channel->fd, &one, sizeof( one ) );
+    (void) r;
+  }
+}
+
+static ssize_t ReadChannel( channel_t *channel, char *buf, size_t size )
+{
+  size_t tail, avail, pos, len, first;
+  bool closed;
+  int ready;
+
+  for ( ;; ) {
+    tail = channel->tail.load( std::memory_order_relaxed );
+    closed = channel->closed.load( std::memory_order_acquire );
+    avail = channel->head.load( std::memory_order_acquire ) - tail;
+    if ( avail > 0 ) {
+      len = ( avail < size ) ? avail : size;
+      pos = tail & ( ChannelSize - 1 );
+      first = ( len < ChannelSize - pos ) ? len : ChannelSize - pos;
+      memcpy( buf, channel->data + pos, first );
+      memcpy( buf + first, channel->data, len - first );
+      channel->tail.store( tail + len, std::memory_order_release );
+      return len;
+    }
+    if ( closed )
+      return 0;
+    /* Empty: block like read() on an empty pipe */
+    PollInput( 1, &channel->fd, &ready, 1 );
+  }
+}
+
+static ssize_t WriteChannel( channel_t *channel, const char *buf, size_t size )
+{
+  size_t head, space, pos, len, first, left = size;
+
+  while ( left > 0 ) {
+    head = channel->head.load( std::memory_order_relaxed );
+    space = ChannelSize - ( head - channel->tail.load( std::memory_order_acquire ) );
+    if ( space == 0 ) {
+      /* Full: the consumer is busy, give it some time */
+      struct timespec delay = { 0, 100000 };
+      nanosleep( &delay, NULL );
+      continue;
+    }
+    len = ( left < space ) ? left : space;
+    pos = head & ( ChannelSize - 1 );
+    first = ( len < ChannelSize - pos ) ? len : ChannelSize - pos;
+    memcpy( channel->data + pos, buf, first );
+    memcpy( channel->data, buf + first, len - first );
+    channel->head.store( head + len, std::memory_order_release );
+    WakeChannel( channel );
+    buf += len;
+    left -= len;
+  }
+  return size;
+}
+
+/*
+ * read() on a channel or a plain descriptor.
+ */
+ssize_t ChannelRead( int fd, void *buf, size_t size )
+{
+  channel_t *channel = FindChannel( fd );
+
+  if ( channel == NULL )
+    return read( fd, buf, size );
+  return ReadChannel( channel, (char *) buf, size );
+}
+
+/*
+ * write() on a channel or a plain descriptor. A channel write never fails.
+ */
+ssize_t ChannelWrite( int fd, const void *buf, size_t size )
+{
+  channel_t *channel = FindChannel( fd );
+
+  if ( channel == NULL )
+    return write( fd, buf, size );
+  return WriteChannel( channel, (const char *) buf, size );
+}
+
+/*
+ * close() on the producer side of a channel or a plain descriptor. The
+ * consumer reads the data left in the channel, then gets EOF.
+ */
+int ChannelClose( int fd )
+{
+  channel_t *channel = FindChannel( fd );
+
+  if ( channel == NULL )
+    return close( fd );
+  channel->closed.store( true, std::memory_order_release );
+  WakeChannel( channel );
+  return 0;
+}
+
+/*
+ * select() on the read side of count channels or plain descriptors, either
+ * polling (wait is 0) or without timeout. Sets ready[i] when fd[i] can be
+ * read without blocking and returns their number, which may be 0 after a
+ * spurious wakeup, or -1 on error. Channels with pending input are detected
+ * without any system call; otherwise the consumer asks the producers to wake
+ * it up before sleeping in select().
+ */
+int PollInput( int count, const int fd[], int ready[], int wait )
+{
+  fd_set set[1];
+  struct timeval time_val[1];
+  channel_t *channel;
+  uint64_t value;
+  int fd_max = -1, n = 0, i;
+
+  for ( i = 0; i < count; i++ ) {
+    channel = FindChannel( fd[i] );
+    ready[i] = ( channel != NULL && ChannelHasInput( channel ) );
+    n += ready[i];
+  }
+  if ( n > 0 )
+    return n;
+
+  FD_ZERO( set );
+  for ( i = 0; i < count; i++ ) {
+    channel = FindChannel( fd[i] );
+    if ( channel != NULL ) {
+      if ( ! wait )
+        continue;
+      channel->waiting.store( true, std::memory_order_relaxed );
+      std::atomic_thread_fence( std::memory_order_seq_cst );
+      if ( ChannelHasInput( channel ) ) {
+        ready[i] = 1;
+        n++;
+      }
+    }
+    FD_SET( fd[i], set );
+    if ( fd[i] > fd_max ) fd_max = fd[i];
+  }
+
+  if ( n == 0 && fd_max >= 0 ) {
+    time_val->tv_sec = 0;
+    time_val->tv_usec = 0;
+    n = select( fd_max+1, set, NULL, NULL, wait ? NULL : time_val );
+    if ( n > 0 ) {
+      n = 0;
+      for ( i = 0; i < count; i++ ) {
+        if ( FD_ISSET( fd[i], set ) ) {
+          channel = FindChannel( fd[i] );
+          if ( channel != NULL ) {
+            /* Reset the eventfd; a wakeup with nothing to read is spurious */
+            ssize_t r = read( channel->fd, &value, sizeof( value ) );
+            (void) r;
+            ready[i] = ChannelHasInput( channel );
+          } else {
+            ready[i] = 1;
+          }
+          n += ready[i];
+        }
+      }
+    }
+  }
+
+  if ( wait ) {
+    for ( i = 0; i < count; i++ ) {
+      channel = FindChannel( fd[i] );
+      if ( channel != NULL )
+        channel->waiting.store( false, std::memory_order_relaxed );
+    }
+  }
+  return n;
+}
+
+#ifdef HAVE_CHANNELS
+
+static ssize_t ChannelStreamRead( void *cookie, char *buf, size_t size )
+{
+  return ReadChannel( (channel_t *) cookie, buf, size );
+}
+
+static ssize_t ChannelStreamWrite( void *cookie, const char *buf, size_t size )
+{
+  return WriteChannel( (channel_t *) cookie, buf, size );
+}
+
+#endif
+
+/*
+ * fdopen() on a channel or a plain descriptor.
+ */
+FILE *ChannelStream( int fd, const char *mode )
+{
+#ifdef HAVE_CHANNELS
+  channel_t *channel = FindChannel( fd );
+
+  if ( channel != NULL ) {
+    cookie_io_functions_t functions = { ChannelStreamRead, ChannelStreamWrite, NULL, NULL };
+    return fopencookie( channel, mode, functions );
+  }
+#endif
+  return fdopen( fd, mode );
+}
@@ -27,6 +27,8 @@
 #define COMPONENTS_H
 
 #include <pthread.h>
+#include <stdio.h>
+#include <sys/types.h>
 
 /* File descriptors for the pipes to be used to communicate frontend, adapter and engine */
 
@@ -38,6 +40,21 @@ extern int pipefd_a2f[2];
 extern int pipefd_a2e[2];
 extern int pipefd_e2a[2];
 
+/*
+ * Channels between frontend, adapter and engine. With the in-process
+ * transport (see UseChannels in components.cc) a channel is a lock-free
+ * single-producer single-consumer ring buffer, and both of its descriptors
+ * are the same eventfd, which becomes readable only when the consumer went
+ * to sleep and the producer woke it up. With the pipe transport, these are
+ * plain wrappers around pipe(), read(), write(), close() and select().
+ */
+int CreateChannel( int fd[2] );
+ssize_t ChannelRead( int fd, void *buf, size_t size );
+ssize_t ChannelWrite( int fd, const void *buf, size_t size );
+int ChannelClose( int fd );
+int PollInput( int count, const int fd[], int ready[], int wait );
+FILE *ChannelStream( int fd, const char *mode );
+
 /*
  * Entry point for the adapter thread
  */
@@ -54,4 +71,9 @@ void InitEngine();
 void TerminateAdapterEngine();
 void TerminateInput();
 
+/*
+ * Runs newline-separated commands on the engine alone and prints its output.
+ */
+void RunEngineCommands( const char *commands );
+
 #endif /* COMPONENTS_H */
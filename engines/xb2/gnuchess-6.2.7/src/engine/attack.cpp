@@ -41,6 +41,23 @@ int DeltaIncAll[DeltaNb];
 int DeltaMask[DeltaNb];
 int IncMask[IncNb];
 
+#if BITBOARD
+
+uint64 SquareBB[SquareNb];
+
+uint64 PawnAttackBB[ColourNb][64];
+uint64 KnightAttackBB[64];
+uint64 KingAttackBB[64];
+uint64 BishopAttackBB[64];
+uint64 RookAttackBB[64];
+
+uint64 RayBB[8][64];
+uint64 BetweenBB[64][64]; // 32 kB
+
+static const int RayInc[8] = { +16, +1, +17, +15, -16, -1, -17, -15 }; // RayBB[] directions
+
+#endif
+
 static int PieceCode[PieceNb];
 
 static int PieceDeltaSize[4][256]; // 4kB
@@ -50,6 +67,10 @@ static int PieceDeltaDelta[4][256][4]; // 16 kB
 
 static void add_attack (int piece, int king, int target);
 
+#if BITBOARD
+static void bb_init    ();
+#endif
+
 // functions
 
 // attack_init()
@@ -235,8 +256,94 @@ void attack_init() {
          PieceDeltaDelta[piece][delta][size] = DeltaNone;
       }
    }
+
+   // bitboards
+
+#if BITBOARD
+   bb_init();
+#endif
+}
+
+#if BITBOARD
+
+// bb_init()
+
+static void bb_init() {
+
+   int sq, sq_64;
+   int from, to;
+   int dir, inc;
+   int colour;
+   const inc_t * inc_ptr;
+   uint64 between;
+
+   // SquareBB[]
+
+   for (sq = 0; sq < SquareNb; sq++) SquareBB[sq] = 0;
+
+   for (sq_64 = 0; sq_64 < 64; sq_64++) {
+      SquareBB[SQUARE_FROM_64(sq_64)] = U64(1) << sq_64;
+   }
+
+   // leaper attacks
+
+   for (sq_64 = 0; sq_64 < 64; sq_64++) {
+
+      from = SQUARE_FROM_64(sq_64);
+
+      for (colour = 0; colour < ColourNb; colour++) {
+         inc = PAWN_MOVE_INC(colour);
+         PawnAttackBB[colour][sq_64] = SQUARE_BB(from+inc-1) | SQUARE_BB(from+inc+1);
+      }
+
+      KnightAttackBB[sq_64] = 0;
+      for (inc_ptr = KnightInc; (inc=*inc_ptr) != IncNone; inc_ptr++) {
+         KnightAttackBB[sq_64] |= SQUARE_BB(from+inc);
+      }
+
+      KingAttackBB[sq_64] = 0;
+      for (inc_ptr = KingInc; (inc=*inc_ptr) != IncNone; inc_ptr++) {
+         KingAttackBB[sq_64] |= SQUARE_BB(from+inc);
+      }
+   }
+
+   // rays
+
+   for (sq_64 = 0; sq_64 < 64; sq_64++) {
+
+      from = SQUARE_FROM_64(sq_64);
+
+      for (dir = 0; dir < 8; dir++) {
+         RayBB[dir][sq_64] = 0;
+         for (to = from+RayInc[dir]; SQUARE_IS_OK(to); to += RayInc[dir]) {
+            RayBB[dir][sq_64] |= SQUARE_BB(to);
+         }
+      }
+
+      BishopAttackBB[sq_64] = RayBB[2][sq_64] | RayBB[3][sq_64] | RayBB[6][sq_64] | RayBB[7][sq_64];
+      RookAttackBB[sq_64]   = RayBB[0][sq_64] | RayBB[1][sq_64] | RayBB[4][sq_64] | RayBB[5][sq_64];
+   }
+
+   // BetweenBB[][]
+
+   for (sq_64 = 0; sq_64 < 64; sq_64++) {
+
+      from = SQUARE_FROM_64(sq_64);
+
+      for (to = 0; to < 64; to++) BetweenBB[sq_64][to] = 0;
+
+      for (dir = 0; dir < 8; dir++) {
+         between = 0;
+         for (to = from+RayInc[dir]; SQUARE_IS_OK(to); to += RayInc[dir]) {
+            BetweenBB[sq_64][SQUARE_TO_64(to)] = between;
+            between |= SQUARE_BB(to);
+         }
+      }
+   }
 }
 
+#endif
+
 // add_attack()
 
 static void add_attack(int piece, int king, int target) {
@@ -266,6 +373,39 @@ static void add_attack(int piece, int king, int target) {
 
 bool is_attacked(const board_t * board, int to, int colour) {
 
+#if BITBOARD
+
+   int sq_64;
+   const uint64 * bb;
+   uint64 occ, slider;
+
+   ASSERT(board!=NULL);
+   ASSERT(SQUARE_IS_OK(to));
+   ASSERT(COLOUR_IS_OK(colour));
+
+   sq_64 = SQUARE_TO_64(to);
+   bb = &board->bb_piece[colour]; // HACK: bb[WhiteXxx12] are colour's pieces
+
+   // leaper attacks
+
+   if ((PawnAttackBB[COLOUR_OPP(colour)][sq_64] & bb[WhitePawn12]) != 0) return true;
+   if ((KnightAttackBB[sq_64] & bb[WhiteKnight12]) != 0) return true;
+   if ((KingAttackBB[sq_64] & bb[WhiteKing12]) != 0) return true;
+
+   // slider attacks (only computed if a slider is on an empty-board line)
+
+   occ = board->bb_colour[White] | board->bb_colour[Black];
+
+   slider = bb[WhiteBishop12] | bb[WhiteQueen12];
+   if ((BishopAttackBB[sq_64] & slider) != 0 && (bishop_attack(sq_64,occ) & slider) != 0) return true;
+
+   slider = bb[WhiteRook12] | bb[WhiteQueen12];
+   if ((RookAttackBB[sq_64] & slider) != 0 && (rook_attack(sq_64,occ) & slider) != 0) return true;
+
+   return false;
+
+#else
+
    int inc;
    int pawn;
    const sq_t * ptr;
@@ -307,12 +447,26 @@ bool is_attacked(const board_t * board, int to, int colour) {
    }
 
    return false;
+
+#endif
 }
 
 // line_is_empty()
 
 bool line_is_empty(const board_t * board, int from, int to) {
 
+#if BITBOARD
+
+   ASSERT(board!=NULL);
+   ASSERT(SQUARE_IS_OK(from));
+   ASSERT(SQUARE_IS_OK(to));
+   ASSERT(delta_is_ok(to-from));
+   ASSERT(DELTA_INC_ALL(to-from)!=IncNone);
+
+   return (BETWEEN_BB(SQUARE_TO_64(from),SQUARE_TO_64(to)) & (board->bb_colour[White]|board->bb_colour[Black])) == 0;
+
+#else
+
    int delta;
    int inc, sq;
 
@@ -333,6 +487,8 @@ bool line_is_empty(const board_t * board, int from, int to) {
    } while (board->square[sq] == Empty);
 
    return false; // blocker
+
+#endif
 }
 
 // is_pinned()
@@ -353,10 +509,14 @@ bool is_pinned(const board_t * board, int square, int colour) {
    inc = DELTA_INC_LINE(to-from);
    if (inc == IncNone) return false; // not a line
 
+#if BITBOARD
+   if ((BETWEEN_BB(SQUARE_TO_64(from),SQUARE_TO_64(to)) & (board->bb_colour[White]|board->bb_colour[Black])) != 0) return false; // blocker
+#else
    sq = from;
    do sq += inc; while (board->square[sq] == Empty);
 
    if (sq != to) return false; // blocker
+#endif
 
    sq = from;
    do sq -= inc; while ((piece=board->square[sq]) == Empty);
@@ -399,8 +559,15 @@ void attack_set(attack_t * attack, const board_t * board) {
    int from, to;
    int inc;
    int pawn;
-   int delta, piece;
+   int piece;
+#if BITBOARD
+   int sq_64;
+   const uint64 * bb;
+   uint64 occ, slider, checker;
+#else
+   int delta;
    int sq;
+#endif
 
    ASSERT(attack!=NULL);
    ASSERT(board!=NULL);
@@ -435,6 +602,41 @@ void attack_set(attack_t * attack, const board_t * board) {
 
    // piece attacks
 
+#if BITBOARD
+
+   sq_64 = SQUARE_TO_64(to);
+   bb = &board->bb_piece[opp]; // HACK: bb[WhiteXxx12] are opp's pieces
+
+   checker = KnightAttackBB[sq_64] & bb[WhiteKnight12];
+
+   occ = board->bb_colour[White] | board->bb_colour[Black];
+
+   slider = bb[WhiteBishop12] | bb[WhiteQueen12];
+   if ((BishopAttackBB[sq_64] & slider) != 0) checker |= bishop_attack(sq_64,occ) & slider;
+
+   slider = bb[WhiteRook12] | bb[WhiteQueen12];
+   if ((RookAttackBB[sq_64] & slider) != 0) checker |= rook_attack(sq_64,occ) & slider;
+
+   if (checker != 0) {
+
+      // piece-list order, as in the ray-walking version
+
+      for (ptr = &board->piece[opp][1]; (from=*ptr) != SquareNone; ptr++) { // HACK: no king
+
+         if ((checker & SQUARE_BB(from)) != 0) {
+
+            piece = board->square[from];
+            inc = (PIECE_IS_SLIDER(piece)) ? DELTA_INC_LINE(to-from) : IncNone;
+
+            attack->ds[attack->dn] = from;
+            attack->di[attack->dn] = -inc; // HACK
+            attack->dn++;
+         }
+      }
+   }
+
+#else
+
    for (ptr = &board->piece[opp][1]; (from=*ptr) != SquareNone; ptr++) { // HACK: no king
 
       piece = board->square[from];
@@ -465,6 +667,8 @@ void attack_set(attack_t * attack, const board_t * board) {
       }
    }
 
+#endif
+
    attack->ds[attack->dn] = SquareNone;
    attack->di[attack->dn] = IncNone;
 
@@ -46,6 +46,11 @@
 
 #define ATTACK_IN_CHECK(attack)           ((attack)->dn!=0)
 
+#if BITBOARD
+#  define SQUARE_BB(square)               (SquareBB[square])
+#  define BETWEEN_BB(sq_64_1,sq_64_2)     (BetweenBB[sq_64_1][sq_64_2])
+#endif
+
 namespace engine {
 
 // types
@@ -64,6 +69,21 @@ extern int DeltaIncAll[DeltaNb];
 extern int DeltaMask[DeltaNb];
 extern int IncMask[IncNb];
 
+#if BITBOARD
+
+extern uint64 SquareBB[SquareNb];
+
+extern uint64 PawnAttackBB[ColourNb][64];
+extern uint64 KnightAttackBB[64];
+extern uint64 KingAttackBB[64];
+extern uint64 BishopAttackBB[64]; // empty board
+extern uint64 RookAttackBB[64]; // empty board
+
+extern uint64 RayBB[8][64]; // 0-3 towards higher squares, 4-7 towards lower squares
+extern uint64 BetweenBB[64][64];
+
+#endif
+
 // functions
 
 extern void attack_init   ();
@@ -79,6 +99,63 @@ extern void attack_set    (attack_t * attack, const board_t * board);
 
 extern bool piece_attack_king (const board_t * board, int piece, int from, int king);
 
+#if BITBOARD
+
+// bitboard helpers
+
+inline int bb_first(uint64 b) {
+
+   ASSERT(b!=0);
+
+#if defined(__GNUC__)
+   return __builtin_ctzll(b);
+#else
+   int sq;
+   for (sq = 0; (b & 1) == 0; sq++) b >>= 1;
+   return sq;
+#endif
+}
+
+inline int bb_last(uint64 b) {
+
+   ASSERT(b!=0);
+
+#if defined(__GNUC__)
+   return 63 ^ __builtin_clzll(b);
+#else
+   int sq;
+   for (sq = 63; (b >> sq) == 0; sq--)
+      ;
+   return sq;
+#endif
+}
+
+inline uint64 ray_attack(int dir, int sq_64, uint64 occ) {
+
+   uint64 attack, blocker;
+
+   attack = RayBB[dir][sq_64];
+   blocker = attack & occ;
+
+   if (blocker != 0) attack ^= RayBB[dir][(dir<4)?bb_first(blocker):bb_last(blocker)];
+
+   return attack;
+}
+
+inline uint64 bishop_attack(int sq_64, uint64 occ) {
+
+   return ray_attack(2,sq_64,occ) | ray_attack(3,sq_64,occ)
+        | ray_attack(6,sq_64,occ) | ray_attack(7,sq_64,occ);
+}
+
+inline uint64 rook_attack(int sq_64, uint64 occ) {
+
+   return ray_attack(0,sq_64,occ) | ray_attack(1,sq_64,occ)
+        | ray_attack(4,sq_64,occ) | ray_attack(5,sq_64,occ);
+}
+
+#endif
+
 }  // namespace engine
 
 #endif // !defined ATTACK_H
@@ -172,6 +172,27 @@ bool board_is_ok(const board_t * board) {
    if (board->number[WhiteKing12] != 1) return false;
    if (board->number[BlackKing12] != 1) return false;
 
+#if BITBOARD
+
+   // bitboards
+
+   for (sq = 0; sq < SquareNb; sq++) {
+
+      if (!SQUARE_IS_OK(sq)) continue;
+
+      piece = board->square[sq];
+
+      for (pos = 0; pos < 12; pos++) {
+         if (((board->bb_piece[pos] & SQUARE_BB(sq)) != 0) != (piece != Empty && PIECE_TO_12(piece) == pos)) return false;
+      }
+
+      for (colour = 0; colour < ColourNb; colour++) {
+         if (((board->bb_colour[colour] & SQUARE_BB(sq)) != 0) != (piece != Empty && COLOUR_IS(piece,colour))) return false;
+      }
+   }
+
+#endif
+
    // misc
 
    if (!COLOUR_IS_OK(board->turn)) return false;
@@ -361,6 +382,26 @@ void board_init_list(board_t * board) {
       if (board->piece_size[colour] + board->pawn_size[colour] > 16) my_fatal("board_init_list(): illegal position\n");
    }
 
+#if BITBOARD
+
+   // bitboards
+
+   for (piece = 0; piece < 12; piece++) board->bb_piece[piece] = 0;
+   for (colour = 0; colour < ColourNb; colour++) board->bb_colour[colour] = 0;
+
+   for (sq_64 = 0; sq_64 < 64; sq_64++) {
+
+      sq = SQUARE_FROM_64(sq_64);
+      piece = board->square[sq];
+
+      if (piece != Empty) {
+         board->bb_piece[PIECE_TO_12(piece)] |= SQUARE_BB(sq);
+         board->bb_colour[PIECE_COLOUR(piece)] |= SQUARE_BB(sq);
+      }
+   }
+
+#endif
+
    // last square
 
    board->cap_sq = SquareNone;
@@ -82,6 +82,11 @@ struct board_t {
 
    int pawn_file[ColourNb][FileNb];
 
+#if BITBOARD
+   uint64 bb_piece[12]; // indexed by PIECE_TO_12(), bit = SQUARE_TO_64()
+   uint64 bb_colour[ColourNb];
+#endif
+
    int turn;
    int flags;
    int ep_square;
@@ -55,10 +55,10 @@ FILE *pipefd_e2a_1_stream;
 
 int main_engine(int argc, char * argv[]) {
 
-   // Get reference stream of pipes to communicate with the adapter
+   // Get reference stream of channels to communicate with the adapter
 
-   pipefd_a2e_0_stream = fdopen( pipefd_a2e[0], "r" );
-   pipefd_e2a_1_stream = fdopen( pipefd_e2a[1], "w" );
+   pipefd_a2e_0_stream = ChannelStream( pipefd_a2e[0], "r" );
+   pipefd_e2a_1_stream = ChannelStream( pipefd_e2a[1], "w" );
    setvbuf(pipefd_a2e_0_stream,NULL,_IONBF,0);
    setvbuf(pipefd_e2a_1_stream,NULL,_IONBF,0); // _IOLBF breaks on Windows!
 
@@ -31,7 +31,9 @@
 #include "material.h"
 #include "option.h"
 #include "piece.h"
+#include "posix.h"
 #include "protocol.h"
+#include "search.h"
 #include "square.h"
 #include "util.h"
 
@@ -40,7 +42,7 @@ namespace engine {
 // constants
 
 static const bool UseTable = true;
-static const uint32 TableSize = 256; // 4kB
+static const int BucketSize = 4; // 4 x 16 bytes = one 64-byte cache line
 
 static const int PawnPhase   = 0;
 static const int KnightPhase = 1;
@@ -74,8 +76,8 @@ typedef material_info_t entry_t;
 
 struct material_t {
    entry_t * table;
-   uint32 size;
-   uint32 mask;
+   uint32 size; // entries
+   uint32 mask; // buckets - 1
    uint32 used;
    sint64 read_nb;
    sint64 read_hit;
@@ -85,7 +87,8 @@ struct material_t {
 
 // variables
 
-static material_t Material[1];
+static material_t MaterialThread[ThreadMax]; // one table per search thread, kept between searches
+static thread_local material_t * Material = &MaterialThread[0];
 
 // prototypes
 
@@ -112,18 +115,78 @@ void material_init() {
 
 void material_alloc() {
 
+   uint64 target;
+   uint32 bucket_nb;
+
    ASSERT(sizeof(entry_t)==16);
 
    if (UseTable) {
 
-      Material->size = TableSize;
-      Material->mask = TableSize - 1;
-      Material->table = (entry_t *) my_malloc(Material->size*sizeof(entry_t));
+      // largest power-of-two number of buckets that fits in "Material Hash"
+
+      target = option_get_int("Material Hash");
+      if (target < 1) target = 1;
+      target *= 1024 * 1024;
+      target /= BucketSize * sizeof(entry_t);
+
+      for (bucket_nb = 1; bucket_nb * uint64(2) <= target; bucket_nb *= 2)
+         ;
+
+      Material->size = bucket_nb * BucketSize;
+      Material->mask = bucket_nb - 1;
+      Material->table = (entry_t *) large_alloc(Material->size*sizeof(entry_t),false); // page-aligned
 
       material_clear();
    }
 }
 
+// material_free()
+
+void material_free() {
+
+   if (Material->table != NULL) {
+      large_free(Material->table,Material->size*sizeof(entry_t));
+      Material->table = NULL;
+   }
+
+   Material->size = 0;
+   Material->mask = 0;
+}
+
+// material_thread()
+
+void material_thread(int id) {
+
+   ASSERT(id>=0&&id<ThreadMax);
+
+   // select the table of search thread "id", allocating it on first use
+
+   Material = &MaterialThread[id];
+
+   if (Material->table == NULL) material_alloc();
+}
+
+// material_free_threads()
+
+void material_free_threads(int id_min) {
+
+   material_t * material;
+   int id;
+
+   ASSERT(id_min>=1&&id_min<=ThreadMax);
+
+   // helper tables from "id_min" on, material_thread() reallocates them when needed
+
+   material = Material;
+
+   for (id = id_min; id < ThreadMax; id++) {
+      Material = &MaterialThread[id];
+      material_free();
+   }
+
+   Material = material;
+}
+
 // material_clear()
 
 void material_clear() {
@@ -139,12 +202,37 @@ void material_clear() {
    Material->write_collision = 0;
 }
 
+// material_stats()
+
+void material_stats() {
+
+   double full, hit, collision;
+
+   if (!UseTable || Material->table == NULL) return;
+
+   if (option_get_bool("Hash Statistics")) {
+
+      // counters of the calling thread's table (one per search thread)
+
+      full = double(Material->used) / double(Material->size);
+      hit = (Material->read_nb > 0) ? double(Material->read_hit) / double(Material->read_nb) : 0.0;
+      collision = (Material->write_nb > 0) ? double(Material->write_collision) / double(Material->write_nb) : 0.0;
+
+      send("info string materialstats kb=%d entries=%d full=%.3f read=" S64_FORMAT " read_hit=" S64_FORMAT " hit=%.4f write=" S64_FORMAT " write_collision=" S64_FORMAT " collision=%.4f",
+           int(Material->size*sizeof(entry_t)>>10),int(Material->size),full,
+           Material->read_nb,Material->read_hit,hit,
+           Material->write_nb,Material->write_collision,collision);
+   }
+}
+
 // material_get_info()
 
 void material_get_info(material_info_t * info, const board_t * board) {
 
    uint64 key;
-   entry_t * entry;
+   uint32 lock;
+   entry_t * bucket;
+   int i;
 
    ASSERT(info!=NULL);
    ASSERT(board!=NULL);
@@ -156,17 +244,21 @@ void material_get_info(material_info_t * info, const board_t * board) {
       Material->read_nb++;
 
       key = board->material_key;
-      entry = &Material->table[KEY_INDEX(key)&Material->mask];
+      lock = KEY_LOCK(key);
+      bucket = &Material->table[(KEY_INDEX(key)&Material->mask)*BucketSize];
+
+      for (i = 0; i < BucketSize; i++) {
 
-      if (entry->lock == KEY_LOCK(key)) {
+         if (bucket[i].lock == lock) {
 
-         // found
+            // found
 
-         Material->read_hit++;
+            Material->read_hit++;
 
-         *info = *entry;
+            *info = bucket[i];
 
-         return;
+            return;
+         }
       }
    }
 
@@ -180,14 +272,18 @@ void material_get_info(material_info_t * info, const board_t * board) {
 
       Material->write_nb++;
 
-      if (entry->lock == 0) { // HACK: assume free entry
+      // most recent first, the last entry of the bucket is replaced
+
+      if (bucket[BucketSize-1].lock == 0) { // HACK: assume free entry
          Material->used++;
       } else {
          Material->write_collision++;
       }
 
-      *entry = *info;
-      entry->lock = KEY_LOCK(key);
+      for (i = BucketSize-1; i > 0; i--) bucket[i] = bucket[i-1];
+
+      bucket[0] = *info;
+      bucket[0].lock = lock;
    }
 }
 
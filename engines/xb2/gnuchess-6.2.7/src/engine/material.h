@@ -72,12 +72,18 @@ struct material_info_t {
 
 // functions
 
-extern void material_init     ();
+extern void material_init         ();
 
-extern void material_alloc    ();
-extern void material_clear    ();
+extern void material_alloc        ();
+extern void material_free         ();
+extern void material_clear        ();
 
-extern void material_get_info (material_info_t * info, const board_t * board);
+extern void material_thread       (int id);
+extern void material_free_threads (int id_min);
+
+extern void material_get_info     (material_info_t * info, const board_t * board);
+
+extern void material_stats        ();
 
 }  // namespace engine
 
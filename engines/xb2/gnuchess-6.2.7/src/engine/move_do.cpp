@@ -233,11 +233,104 @@ void move_do(board_t * board, int move, undo_t * undo) {
       }
    }
 
+   // start loading the pawn-table entry eval() will need, the DRAM latency
+   // then overlaps with the draw and mate-distance tests of the child node
+
+   if (board->pawn_key != undo->pawn_key) pawn_prefetch(board->pawn_key);
+
    // debug
 
    ASSERT(board_is_ok(board));
 }
 
+// move_do_key()
+
+uint64 move_do_key(int move, const board_t * board) {
+
+   int me, opp;
+   int from, to;
+   int piece, capture;
+   int flags;
+   int delta;
+   int sq;
+   int pawn, rook;
+   uint64 key;
+
+   ASSERT(move_is_ok(move));
+   ASSERT(board!=NULL);
+
+   // hash key move_do() will produce, without touching the board
+
+   me = board->turn;
+   opp = COLOUR_OPP(me);
+
+   from = MOVE_FROM(move);
+   to = MOVE_TO(move);
+
+   piece = board->square[from];
+   ASSERT(COLOUR_IS(piece,me));
+
+   // turn
+
+   key = board->key ^ RANDOM_64(RandomTurn);
+
+   // castling rights
+
+   flags = board->flags;
+   key ^= Castle64[flags^(flags&CastleMask[from]&CastleMask[to])];
+
+   // en-passant square
+
+   if ((sq=board->ep_square) != SquareNone) {
+      key ^= RANDOM_64(RandomEnPassant+SQUARE_FILE(sq)-FileA);
+   }
+
+   if (PIECE_IS_PAWN(piece)) {
+
+      delta = to - from;
+
+      if (delta == +32 || delta == -32) {
+         pawn = PAWN_MAKE(opp);
+         if (board->square[to-1] == pawn || board->square[to+1] == pawn) {
+            key ^= RANDOM_64(RandomEnPassant+SQUARE_FILE(to)-FileA);
+         }
+      }
+   }
+
+   // captured piece
+
+   sq = to;
+   if (MOVE_IS_EN_PASSANT(move)) sq = SQUARE_EP_DUAL(sq);
+
+   if ((capture=board->square[sq]) != Empty) key ^= hash_piece_key(capture,sq);
+
+   // moving piece
+
+   key ^= hash_piece_key(piece,from);
+   key ^= hash_piece_key((MOVE_IS_PROMOTE(move))?move_promote(move):piece,to);
+
+   // rook in case of castling
+
+   if (MOVE_IS_CASTLE(move)) {
+
+      rook = Rook64 | COLOUR_FLAG(me); // HACK
+
+      if (to == G1) {
+         key ^= hash_piece_key(rook,H1) ^ hash_piece_key(rook,F1);
+      } else if (to == C1) {
+         key ^= hash_piece_key(rook,A1) ^ hash_piece_key(rook,D1);
+      } else if (to == G8) {
+         key ^= hash_piece_key(rook,H8) ^ hash_piece_key(rook,F8);
+      } else if (to == C8) {
+         key ^= hash_piece_key(rook,A8) ^ hash_piece_key(rook,D8);
+      } else {
+         ASSERT(false);
+      }
+   }
+
+   return key;
+}
+
 // move_undo()
 
 void move_undo(board_t * board, int move, const undo_t * undo) {
@@ -441,6 +534,15 @@ static void square_clear(board_t * board, int square, int piece, bool update) {
    ASSERT(board->square[square]==piece);
    board->square[square] = Empty;
 
+#if BITBOARD
+
+   // bitboards
+
+   board->bb_piece[piece_12] ^= SQUARE_BB(square);
+   board->bb_colour[colour] ^= SQUARE_BB(square);
+
+#endif
+
    // piece list
 
    if (!PIECE_IS_PAWN(piece)) {
@@ -570,6 +672,15 @@ static void square_set(board_t * board, int square, int piece, int pos, bool upd
    ASSERT(board->square[square]==Empty);
    board->square[square] = piece;
 
+#if BITBOARD
+
+   // bitboards
+
+   board->bb_piece[piece_12] ^= SQUARE_BB(square);
+   board->bb_colour[colour] ^= SQUARE_BB(square);
+
+#endif
+
    // piece list
 
    if (!PIECE_IS_PAWN(piece)) {
@@ -717,6 +828,15 @@ static void square_move(board_t * board, int from, int to, int piece, bool updat
    ASSERT(board->pos[to]==-1);
    board->pos[to] = pos;
 
+#if BITBOARD
+
+   // bitboards
+
+   board->bb_piece[PIECE_TO_12(piece)] ^= SQUARE_BB(from) ^ SQUARE_BB(to);
+   board->bb_colour[colour] ^= SQUARE_BB(from) ^ SQUARE_BB(to);
+
+#endif
+
    // piece list
 
    if (!PIECE_IS_PAWN(piece)) {
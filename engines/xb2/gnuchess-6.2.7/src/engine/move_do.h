@@ -65,6 +65,8 @@ extern void move_do_init   ();
 extern void move_do        (board_t * board, int move, undo_t * undo);
 extern void move_undo      (board_t * board, int move, const undo_t * undo);
 
+extern uint64 move_do_key  (int move, const board_t * board);
+
 extern void move_do_null   (board_t * board, undo_t * undo);
 extern void move_undo_null (board_t * board, const undo_t * undo);
 
@@ -46,7 +46,13 @@ struct option_t {
 
 static option_t Option[] = {
 
-   { "Hash", true, "16", "spin", "min 4 max 1024", NULL },
+   { "Hash", true, "16", "spin", "min 4 max 262144", NULL },
+   { "Huge Pages", true, "false", "check", "", NULL },
+   { "Hash Statistics", true, "false", "check", "", NULL },
+   { "Pawn Hash", true, "1", "spin", "min 1 max 1024", NULL },
+   { "Material Hash", true, "1", "spin", "min 1 max 1024", NULL },
+
+   { "Threads", true, "1", "spin", "min 1 max 64", NULL },
 
    { "Ponder", true, "false", "check", "", NULL },
 
@@ -31,7 +31,9 @@
 #include "option.h"
 #include "pawn.h"
 #include "piece.h"
+#include "posix.h"
 #include "protocol.h"
+#include "search.h"
 #include "square.h"
 #include "util.h"
 
@@ -40,7 +42,7 @@ namespace engine {
 // constants
 
 static const bool UseTable = true;
-static const uint32 TableSize = 16384; // 256kB
+static const int BucketSize = 4; // 4 x 16 bytes = one 64-byte cache line
 
 // types
 
@@ -48,8 +50,8 @@ typedef pawn_info_t entry_t;
 
 struct pawn_t {
    entry_t * table;
-   uint32 size;
-   uint32 mask;
+   uint32 size; // entries
+   uint32 mask; // buckets - 1
    uint32 used;
    sint64 read_nb;
    sint64 read_hit;
@@ -101,7 +103,8 @@ int BitLast[0x100];
 int BitCount[0x100];
 int BitRev[0x100];
 
-static pawn_t Pawn[1];
+static pawn_t PawnThread[ThreadMax]; // one table per search thread, kept between searches
+static thread_local pawn_t * Pawn = &PawnThread[0];
 
 static int BitRank1[RankNb];
 static int BitRank2[RankNb];
@@ -205,18 +208,78 @@ void pawn_init() {
 
 void pawn_alloc() {
 
+   uint64 target;
+   uint32 bucket_nb;
+
    ASSERT(sizeof(entry_t)==16);
 
    if (UseTable) {
 
-      Pawn->size = TableSize;
-      Pawn->mask = TableSize - 1;
-      Pawn->table = (entry_t *) my_malloc(Pawn->size*sizeof(entry_t));
+      // largest power-of-two number of buckets that fits in "Pawn Hash"
+
+      target = option_get_int("Pawn Hash");
+      if (target < 1) target = 1;
+      target *= 1024 * 1024;
+      target /= BucketSize * sizeof(entry_t);
+
+      for (bucket_nb = 1; bucket_nb * uint64(2) <= target; bucket_nb *= 2)
+         ;
+
+      Pawn->size = bucket_nb * BucketSize;
+      Pawn->mask = bucket_nb - 1;
+      Pawn->table = (entry_t *) large_alloc(Pawn->size*sizeof(entry_t),false); // page-aligned
 
       pawn_clear();
    }
 }
 
+// pawn_free()
+
+void pawn_free() {
+
+   if (Pawn->table != NULL) {
+      large_free(Pawn->table,Pawn->size*sizeof(entry_t));
+      Pawn->table = NULL;
+   }
+
+   Pawn->size = 0;
+   Pawn->mask = 0;
+}
+
+// pawn_thread()
+
+void pawn_thread(int id) {
+
+   ASSERT(id>=0&&id<ThreadMax);
+
+   // select the table of search thread "id", allocating it on first use
+
+   Pawn = &PawnThread[id];
+
+   if (Pawn->table == NULL) pawn_alloc();
+}
+
+// pawn_free_threads()
+
+void pawn_free_threads(int id_min) {
+
+   pawn_t * pawn;
+   int id;
+
+   ASSERT(id_min>=1&&id_min<=ThreadMax);
+
+   // helper tables from "id_min" on, pawn_thread() reallocates them when needed
+
+   pawn = Pawn;
+
+   for (id = id_min; id < ThreadMax; id++) {
+      Pawn = &PawnThread[id];
+      pawn_free();
+   }
+
+   Pawn = pawn;
+}
+
 // pawn_clear()
 
 void pawn_clear() {
@@ -232,12 +295,44 @@ void pawn_clear() {
    Pawn->write_collision = 0;
 }
 
+// pawn_prefetch()
+
+void pawn_prefetch(uint64 key) {
+
+   if (UseTable) PREFETCH(&Pawn->table[(KEY_INDEX(key)&Pawn->mask)*BucketSize]);
+}
+
+// pawn_stats()
+
+void pawn_stats() {
+
+   double full, hit, collision;
+
+   if (!UseTable || Pawn->table == NULL) return;
+
+   if (option_get_bool("Hash Statistics")) {
+
+      // counters of the calling thread's table (one per search thread)
+
+      full = double(Pawn->used) / double(Pawn->size);
+      hit = (Pawn->read_nb > 0) ? double(Pawn->read_hit) / double(Pawn->read_nb) : 0.0;
+      collision = (Pawn->write_nb > 0) ? double(Pawn->write_collision) / double(Pawn->write_nb) : 0.0;
+
+      send("info string pawnstats kb=%d entries=%d full=%.3f read=" S64_FORMAT " read_hit=" S64_FORMAT " hit=%.4f write=" S64_FORMAT " write_collision=" S64_FORMAT " collision=%.4f",
+           int(Pawn->size*sizeof(entry_t)>>10),int(Pawn->size),full,
+           Pawn->read_nb,Pawn->read_hit,hit,
+           Pawn->write_nb,Pawn->write_collision,collision);
+   }
+}
+
 // pawn_get_info()
 
 void pawn_get_info(pawn_info_t * info, const board_t * board) {
 
    uint64 key;
-   entry_t * entry;
+   uint32 lock;
+   entry_t * bucket;
+   int i;
 
    ASSERT(info!=NULL);
    ASSERT(board!=NULL);
@@ -249,17 +344,21 @@ void pawn_get_info(pawn_info_t * info, const board_t * board) {
       Pawn->read_nb++;
 
       key = board->pawn_key;
-      entry = &Pawn->table[KEY_INDEX(key)&Pawn->mask];
+      lock = KEY_LOCK(key);
+      bucket = &Pawn->table[(KEY_INDEX(key)&Pawn->mask)*BucketSize];
+
+      for (i = 0; i < BucketSize; i++) {
 
-      if (entry->lock == KEY_LOCK(key)) {
+         if (bucket[i].lock == lock) {
 
-         // found
+            // found
 
-         Pawn->read_hit++;
+            Pawn->read_hit++;
 
-         *info = *entry;
+            *info = bucket[i];
 
-         return;
+            return;
+         }
       }
    }
 
@@ -273,14 +372,18 @@ void pawn_get_info(pawn_info_t * info, const board_t * board) {
 
       Pawn->write_nb++;
 
-      if (entry->lock == 0) { // HACK: assume free entry
+      // most recent first, the last entry of the bucket is replaced
+
+      if (bucket[BucketSize-1].lock == 0) { // HACK: assume free entry
          Pawn->used++;
       } else {
          Pawn->write_collision++;
       }
 
-      *entry = *info;
-      entry->lock = KEY_LOCK(key);
+      for (i = BucketSize-1; i > 0; i--) bucket[i] = bucket[i-1];
+
+      bucket[0] = *info;
+      bucket[0].lock = lock;
    }
 }
 
@@ -71,15 +71,22 @@ extern int BitRev[0x100];
 
 // functions
 
-extern void pawn_init_bit ();
-extern void pawn_init     ();
+extern void pawn_init_bit     ();
+extern void pawn_init         ();
 
-extern void pawn_alloc    ();
-extern void pawn_clear    ();
+extern void pawn_alloc        ();
+extern void pawn_free         ();
+extern void pawn_clear        ();
 
-extern void pawn_get_info (pawn_info_t * info, const board_t * board);
+extern void pawn_thread       (int id);
+extern void pawn_free_threads (int id_min);
 
-extern int  quad          (int y_min, int y_max, int x);
+extern void pawn_get_info     (pawn_info_t * info, const board_t * board);
+extern void pawn_prefetch     (uint64 key);
+
+extern void pawn_stats        ();
+
+extern int  quad              (int y_min, int y_max, int x);
 
 }  // namespace engine
 
@@ -32,6 +32,7 @@
 #if defined(_WIN32) || defined(_WIN64)
 #  include <windows.h>
 #else // assume POSIX
+#  include <sys/mman.h>
 #  include <sys/resource.h>
 #  include <sys/time.h>
 #  include <sys/types.h>
@@ -53,6 +54,8 @@ namespace engine {
 
 static const bool UseDebug = false;
 
+static const uint64 LargePageSize = 2 * 1024 * 1024; // x86-64 huge page
+
 // prototypes
 
 #if !defined(_WIN32) && !defined(_WIN64)
@@ -137,16 +140,11 @@ bool input_available() {
 #else // assume POSIX
 
    int val;
-   fd_set set[1];
-   struct timeval time_val[1];
-
-   FD_ZERO(set);
-   FD_SET(pipefd_a2e[0],set);
+   int ready;
 
-   time_val->tv_sec = 0;
-   time_val->tv_usec = 0;
+   // a memory read with the in-process transport, a select() with pipes
 
-   val = select(pipefd_a2e[0]+1,set,NULL,NULL,time_val);
+   val = PollInput(1,&pipefd_a2e[0],&ready,false);
    if (val == -1 && errno != EINTR) {
       my_fatal("input_available(): select(): %s\n",strerror(errno));
    }
@@ -202,6 +200,68 @@ double now_cpu() {
 #endif
 }
 
+// large_alloc()
+
+void * large_alloc(uint64 size, bool huge_pages) {
+
+   void * address;
+
+   ASSERT(size>0);
+
+   // page-aligned (hence cache-line aligned) memory for big tables
+
+   size = (size + LargePageSize - 1) / LargePageSize * LargePageSize;
+
+   if (size != uint64(size_t(size))) my_fatal("large_alloc(): size too large\n");
+
+#if defined(_WIN32) || defined(_WIN64)
+
+   // large pages need a special privilege under Windows, do not bother
+
+   address = VirtualAlloc(NULL,size,MEM_RESERVE|MEM_COMMIT,PAGE_READWRITE);
+   if (address == NULL) my_fatal("large_alloc(): VirtualAlloc() failed\n");
+
+#else // assume POSIX
+
+   address = MAP_FAILED;
+
+#  ifdef MAP_HUGETLB
+   if (huge_pages) { // needs pre-reserved pages (vm.nr_hugepages)
+      address = mmap(NULL,size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB,-1,0);
+   }
+#  endif
+
+   if (address == MAP_FAILED) {
+
+      address = mmap(NULL,size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+      if (address == MAP_FAILED) my_fatal("large_alloc(): mmap(): %s\n",strerror(errno));
+
+#  ifdef MADV_HUGEPAGE
+      if (huge_pages) madvise(address,size,MADV_HUGEPAGE); // transparent huge pages
+#  endif
+   }
+
+#endif
+
+   return address;
+}
+
+// large_free()
+
+void large_free(void * address, uint64 size) {
+
+   ASSERT(address!=NULL);
+   ASSERT(size>0);
+
+   size = (size + LargePageSize - 1) / LargePageSize * LargePageSize;
+
+#if defined(_WIN32) || defined(_WIN64)
+   VirtualFree(address,0,MEM_RELEASE);
+#else // assume POSIX
+   munmap(address,size);
+#endif
+}
+
 // duration()
 
 #if !defined(_WIN32) && !defined(_WIN64)
@@ -37,6 +37,9 @@ extern bool   input_available ();
 extern double now_real        ();
 extern double now_cpu         ();
 
+extern void * large_alloc     (uint64 size, bool huge_pages);
+extern void   large_free      (void * address, uint64 size);
+
 }  // namespace engine
 
 #endif // !defined POSIX_H
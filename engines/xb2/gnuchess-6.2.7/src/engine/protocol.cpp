@@ -36,6 +36,7 @@
 #include "material.h"
 #include "move.h"
 #include "move_do.h"
+#include "move_gen.h"
 #include "move_legal.h"
 #include "option.h"
 #include "pawn.h"
@@ -54,6 +55,29 @@ namespace engine {
 static const double NormalRatio = 1.0;
 static const double PonderRatio = 1.25;
 
+static const int BenchDepth = 8; // default "bench" depth
+
+static const char * const BenchFen[] = { // "bench" position suite
+   "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+   "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+   "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11",
+   "4rrk1/pp1n3p/3q2pQ/2p1pb2/2PP4/2P3N1/P2B2PP/4RRK1 b - - 7 19",
+   "rq3rk1/ppp2ppp/1bnpb3/3N2B1/3NP3/7P/PPPQ1PP1/2KR3R w - - 7 14",
+   "r1bq1r1k/1pp1n1pp/1p1p4/4p2Q/4Pp2/1BNP4/PPP2PPP/3R1RK1 w - - 2 14",
+   "r3r1k1/2p2ppp/p1p1bn2/8/1q2P3/2NPQN2/PPP3PP/R4RK1 b - - 2 15",
+   "r1bbk1nr/pp3p1p/2n5/1N4p1/2Np1B2/8/PPP2PPP/2KR1B1R w kq - 0 13",
+   "r1bq1rk1/ppp1nppp/4n3/3p3Q/3P4/1BP1B3/PP1N2PP/R4RK1 w - - 1 16",
+   "4r1k1/r1q2ppp/ppp2n2/4P3/5Rb1/1N1BQ3/PPP3PP/R5K1 w - - 1 17",
+   "2rqkb1r/ppp2p2/2npb1p1/1N1Nn2p/2P1PP2/8/PP2B1PP/R1BQK2R b KQ - 0 11",
+   "3r1rk1/p5pp/bpp1pp2/8/q1PP1P2/b3P3/P2NQRPP/1R2B1K1 b - - 6 22",
+   "4k2r/1pb2ppp/1p2p3/1R1p4/3P4/2r1PN2/P4PPP/1R4K1 b - - 3 22",
+   "6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/8 b - - 0 1",
+   "8/8/8/8/5kp1/P7/8/1K1N4 w - - 0 1",
+   "8/3k4/8/8/8/4B3/4KB2/2B5 w - - 0 1",
+};
+
+static const int BenchFenNb = int(sizeof(BenchFen) / sizeof(BenchFen[0]));
+
 // variables
 
 static bool Init;
@@ -61,6 +85,7 @@ static bool Init;
 static bool Searching; // search in progress?
 static bool Infinite; // infinite or ponder mode?
 static bool Delay; // postpone "bestmove" in infinite/ponder mode?
+static bool Bench; // "bench" in progress? (input is left queued)
 
 extern bool UseTrans;
 
@@ -74,12 +99,16 @@ extern FILE *pipefd_e2a_1_stream;
 static void init              ();
 static void loop_step         ();
 
+static void parse_bench       (char string[]);
 static void parse_go          (char string[]);
+static void parse_perft       (char string[], bool divide);
 static void parse_position    (char string[]);
 static void parse_setoption   (char string[]);
 
 static void send_best_move    ();
 
+static sint64 perft           (board_t * board, int depth);
+
 static bool string_equal      (const char s1[], const char s2[]);
 static bool string_start_with (const char s1[], const char s2[]);
 
@@ -96,6 +125,7 @@ void loop() {
    Searching = false;
    Infinite = false;
    Delay = false;
+   Bench = false;
 
    search_clear();
 
@@ -137,6 +167,8 @@ static void init() {
 
 void event() {
 
+   if (Bench) return; // commands sent during "bench" are read after it
+
    while (!SearchInfo->stop && input_available()) loop_step();
 }
 
@@ -154,10 +186,27 @@ static void loop_step() {
 
    if (false) {
 
+   } else if (string_equal(string,"bench") || string_start_with(string,"bench ")) {
+
+      if (!Searching && !Delay) {
+         init();
+         parse_bench(string);
+      } else {
+         ASSERT(false);
+      }
+
    } else if (string_start_with(string,"debug ")) {
 
       // dummy
 
+   } else if (string_start_with(string,"divide ")) {
+
+      if (!Searching && !Delay) {
+         parse_perft(string,true);
+      } else {
+         ASSERT(false);
+      }
+
    } else if (string_start_with(string,"go ")) {
 
       if (!Searching && !Delay) {
@@ -175,6 +224,14 @@ static void loop_step() {
 
       send("readyok"); // no need to wait when searching (dixit SMK)
 
+   } else if (string_start_with(string,"perft ")) {
+
+      if (!Searching && !Delay) {
+         parse_perft(string,false);
+      } else {
+         ASSERT(false);
+      }
+
    } else if (string_equal(string,"ponderhit")) {
 
       if (Searching) {
@@ -208,6 +265,9 @@ static void loop_step() {
       ASSERT(!Searching);
       ASSERT(!Delay);
 
+      pawn_free_threads(1);
+      material_free_threads(1);
+
       //exit(EXIT_SUCCESS);
       pthread_exit(NULL);
 
@@ -263,6 +323,87 @@ static void loop_step() {
    }
 }
 
+// parse_bench()
+
+static void parse_bench(char string[]) {
+
+   const char * ptr;
+   int depth;
+   bool own_book;
+   board_t board[1];
+   my_timer_t timer[1];
+   int pos;
+   sint64 node_nb;
+   double time, speed;
+
+   // parse
+
+   depth = BenchDepth;
+
+   ptr = strtok(string," "); // skip "bench"
+   ptr = strtok(NULL," ");
+
+   if (ptr != NULL) depth = atoi(ptr);
+   if (depth < 1 || depth >= DepthMax) depth = BenchDepth;
+
+   // init
+
+   board_copy(board,SearchInput->board); // restored below
+
+   own_book = option_get_bool("OwnBook");
+   option_set("OwnBook","false"); // always search
+
+   Bench = true;
+   node_nb = 0;
+
+   my_timer_reset(timer);
+   my_timer_start(timer);
+
+   // position loop
+
+   for (pos = 0; pos < BenchFenNb; pos++) {
+
+      // same start for every position => reproducible node counts (with Threads = 1)
+
+      board_from_fen(SearchInput->board,BenchFen[pos]);
+
+      trans_clear(Trans);
+      search_clear();
+
+      SearchInput->depth_is_limited = true;
+      SearchInput->depth_limit = depth;
+
+      Searching = true;
+
+      search();
+      search_update_current();
+
+      Searching = false;
+
+      node_nb += SearchCurrent->node_nb;
+
+      send("info string bench position %d/%d nodes " S64_FORMAT " time %.0f",pos+1,BenchFenNb,SearchCurrent->node_nb,SearchCurrent->time*1000.0);
+   }
+
+   my_timer_stop(timer);
+
+   // restore
+
+   Bench = false;
+
+   option_set("OwnBook",(own_book)?"true":"false");
+   board_copy(SearchInput->board,board);
+   search_clear();
+
+   // report
+
+   time = my_timer_elapsed_real(timer);
+   speed = (time > 0.0) ? double(node_nb) / time : 0.0;
+
+   send("info string bench depth %d positions %d nodes " S64_FORMAT " time %.0f nps %.0f",depth,BenchFenNb,node_nb,time*1000.0,speed);
+   send("info string bench signature " S64_FORMAT,node_nb);
+}
+
 // parse_go()
 
 static void parse_go(char string[]) {
@@ -464,6 +605,73 @@ static void parse_go(char string[]) {
    if (!Delay) send_best_move();
 }
 
+// parse_perft()
+
+static void parse_perft(char string[], bool divide) {
+
+   const char * ptr;
+   int depth;
+   board_t board[1];
+   list_t list[1];
+   undo_t undo[1];
+   int i, move;
+   sint64 node_nb, move_nb;
+   my_timer_t timer[1];
+   double time, speed;
+   char move_string[256];
+
+   // parse
+
+   ptr = strtok(string," "); // skip "perft"/"divide"
+   ptr = strtok(NULL," ");
+
+   if (ptr == NULL) return;
+
+   depth = atoi(ptr);
+   if (depth < 1 || depth >= DepthMax) return;
+
+   // count
+
+   board_copy(board,SearchInput->board);
+
+   my_timer_reset(timer);
+   my_timer_start(timer);
+
+   if (divide) {
+
+      node_nb = 0;
+
+      gen_legal_moves(list,board);
+
+      for (i = 0; i < LIST_SIZE(list); i++) {
+
+         move = LIST_MOVE(list,i);
+
+         move_do(board,move,undo);
+         move_nb = perft(board,depth-1);
+         move_undo(board,move,undo);
+
+         node_nb += move_nb;
+
+         move_to_string(move,move_string,256);
+         send("info string divide %s " S64_FORMAT,move_string,move_nb);
+      }
+
+   } else {
+
+      node_nb = perft(board,depth);
+   }
+
+   my_timer_stop(timer);
+
+   // report
+
+   time = my_timer_elapsed_real(timer);
+   speed = (time > 0.0) ? double(node_nb) / time : 0.0;
+
+   send("info string perft depth %d nodes " S64_FORMAT " time %.0f nps %.0f",depth,node_nb,time*1000.0,speed);
+}
+
 // parse_position()
 
 static void parse_position(char string[]) {
@@ -535,6 +743,7 @@ static void parse_setoption(char string[]) {
 
    const char * name;
    char * value;
+   int thread_nb;
 
    // init
 
@@ -553,7 +762,7 @@ static void parse_setoption(char string[]) {
 
    // update transposition-table size if needed
 
-   if (Init && my_string_equal(name,"Hash")) { // Init => already allocated
+   if (Init && (my_string_equal(name,"Hash") || my_string_equal(name,"Huge Pages"))) { // Init => already allocated
 
       ASSERT(!Searching);
 
@@ -562,6 +771,41 @@ static void parse_setoption(char string[]) {
          trans_alloc(Trans);
       }
    }
+
+   // update pawn and material-table sizes if needed (helper threads reallocate theirs at search start)
+
+   if (Init && my_string_equal(name,"Pawn Hash")) {
+
+      ASSERT(!Searching);
+
+      pawn_free();
+      pawn_alloc();
+      pawn_free_threads(1);
+   }
+
+   if (Init && my_string_equal(name,"Material Hash")) {
+
+      ASSERT(!Searching);
+
+      material_free();
+      material_alloc();
+      material_free_threads(1);
+   }
+
+   // release the tables of helper threads that are no longer used
+
+   if (my_string_equal(name,"Threads")) {
+
+      ASSERT(!Searching);
+
+      thread_nb = option_get_int("Threads");
+      if (thread_nb < 1) thread_nb = 1;
+
+      if (thread_nb < ThreadMax) {
+         pawn_free_threads(thread_nb);
+         material_free_threads(thread_nb);
+      }
+   }
 }
 
 // send_best_move()
@@ -587,8 +831,8 @@ static void send_best_move() {
    send("info time %.0f nodes " S64_FORMAT " nps %.0f cpuload %.0f",time*1000.0,node_nb,speed,cpu*1000.0);
 
    trans_stats(Trans);
-   // pawn_stats();
-   // material_stats();
+   pawn_stats();
+   material_stats();
 
    // best move
 
@@ -605,6 +849,40 @@ static void send_best_move() {
    }
 }
 
+// perft()
+
+static sint64 perft(board_t * board, int depth) {
+
+   list_t list[1];
+   undo_t undo[1];
+   int i, move;
+   sint64 node_nb;
+
+   ASSERT(board_is_ok(board));
+   ASSERT(depth>=0);
+
+   // leaf
+
+   if (depth == 0) return 1;
+
+   // move loop (move_do() is exercised down to the leaves, no bulk counting)
+
+   node_nb = 0;
+
+   gen_legal_moves(list,board);
+
+   for (i = 0; i < LIST_SIZE(list); i++) {
+
+      move = LIST_MOVE(list,i);
+
+      move_do(board,move,undo);
+      node_nb += perft(board,depth-1);
+      move_undo(board,move,undo);
+   }
+
+   return node_nb;
+}
+
 // get()
 
 void get(char string[], int size) {
@@ -24,6 +24,7 @@
 // includes
 
 #include <csetjmp>
+#include <pthread.h>
 
 #include "attack.h"
 #include "board.h"
@@ -72,17 +73,35 @@ static const bool UseBad = true;
 static const int BadThreshold = 50; // 50
 static const bool UseExtension = true;
 
+// types
+
+struct search_thread_t {
+   pthread_t thread;
+   int id;
+   volatile sint64 node_nb; // published by the helper at every search_check()
+   sint64 node_seen; // part of node_nb already added to the main thread count
+};
+
 // variables
 
 search_input_t SearchInput[1];
-search_info_t SearchInfo[1];
-search_root_t SearchRoot[1];
-search_current_t SearchCurrent[1];
-search_best_t SearchBest[1];
+thread_local search_info_t SearchInfo[1];
+thread_local search_root_t SearchRoot[1];
+thread_local search_current_t SearchCurrent[1];
+thread_local search_best_t SearchBest[1];
+
+static search_thread_t SearchThread[ThreadMax];
+static int SearchThreadNb; // including the main thread
+static volatile bool SearchThreadStop;
 
 // prototypes
 
-static void search_send_stat ();
+static void   search_send_stat    ();
+
+static void   search_thread_start ();
+static void   search_thread_stop  ();
+static void * search_thread       (void * arg);
+static void   search_thread_nodes ();
 
 // functions
 
@@ -120,6 +139,7 @@ void search_clear() {
    SearchInfo->check_nb = 10000; // was 100000
    SearchInfo->check_inc = 10000; // was 100000
    SearchInfo->last_time = 0.0;
+   SearchInfo->thread_id = 0;
 
    // SearchBest
 
@@ -196,6 +216,7 @@ void search() {
    if (setjmp(SearchInfo->buf) != 0) {
       ASSERT(SearchInfo->can_stop);
       ASSERT(SearchBest->move!=MoveNone);
+      search_thread_stop();
       search_update_current();
       return;
    }
@@ -217,6 +238,10 @@ void search() {
    sort_init();
    search_full_init(SearchRoot->list,SearchCurrent->board);
 
+   // helper threads (they only share the transposition table with us)
+
+   search_thread_start();
+
    // iterative deepening
 
    for (depth = 1; depth < DepthMax; depth++) {
@@ -293,6 +318,9 @@ void search() {
          break;
       }
    }
+
+   search_thread_stop();
+   search_update_current();
 }
 
 // search_update_best()
@@ -306,6 +334,8 @@ void search_update_best() {
    int mate;
    char move_string[256], pv_string[512];
 
+   if (SearchInfo->thread_id != 0) return; // helper threads do not report
+
    search_update_current();
 
    if (DispBest) {
@@ -375,7 +405,7 @@ void search_update_root() {
    sint64 node_nb;
    char move_string[256];
 
-   if (DispRoot) {
+   if (DispRoot && SearchInfo->thread_id == 0) {
 
       search_update_current();
 
@@ -405,6 +435,8 @@ void search_update_current() {
 
    timer = SearchCurrent->timer;
 
+   search_thread_nodes();
+
    node_nb = SearchCurrent->node_nb;
    time = (UseCpuTime) ? my_timer_elapsed_cpu(timer) : my_timer_elapsed_real(timer);
    speed = (time >= 1.0) ? double(node_nb) / time : 0.0;
@@ -419,6 +451,14 @@ void search_update_current() {
 
 void search_check() {
 
+   if (SearchInfo->thread_id != 0) { // helper thread
+
+      SearchThread[SearchInfo->thread_id].node_nb = SearchCurrent->node_nb;
+      if (SearchThreadStop) longjmp(SearchInfo->buf,1);
+
+      return;
+   }
+
    search_send_stat();
 
    if (UseEvent) event();
@@ -468,6 +508,108 @@ static void search_send_stat() {
       send("info time %.0f nodes " S64_FORMAT " nps %.0f cpuload %.0f",time*1000.0,node_nb,speed,cpu*1000.0);
 
       trans_stats(Trans);
+      pawn_stats();
+      material_stats();
+   }
+}
+
+// search_thread_start()
+
+static void search_thread_start() {
+
+   int id;
+
+   SearchThreadNb = option_get_int("Threads");
+   if (SearchThreadNb < 1) SearchThreadNb = 1;
+   if (SearchThreadNb > ThreadMax) SearchThreadNb = ThreadMax;
+
+   SearchThreadStop = false;
+
+   for (id = 1; id < SearchThreadNb; id++) {
+
+      SearchThread[id].id = id;
+      SearchThread[id].node_nb = 0;
+      SearchThread[id].node_seen = 0;
+
+      if (pthread_create(&SearchThread[id].thread,NULL,search_thread,&SearchThread[id]) != 0) {
+         SearchThreadNb = id; // run with what we have
+         break;
+      }
+   }
+}
+
+// search_thread_stop()
+
+static void search_thread_stop() {
+
+   int id;
+
+   ASSERT(SearchInfo->thread_id==0);
+
+   SearchThreadStop = true;
+
+   for (id = 1; id < SearchThreadNb; id++) {
+      pthread_join(SearchThread[id].thread,NULL);
+   }
+
+   search_thread_nodes();
+
+   SearchThreadNb = 1;
+}
+
+// search_thread()
+
+static void * search_thread(void * arg) {
+
+   search_thread_t * thread;
+   int depth;
+
+   thread = (search_thread_t *) arg;
+
+   // private state (the transposition table is the only shared structure)
+
+   SearchInfo->thread_id = thread->id;
+   SearchInfo->check_nb = SearchInfo->check_inc = 10000;
+
+   SearchCurrent->node_nb = 0;
+   SearchCurrent->max_depth = 0;
+
+   pawn_thread(thread->id); // tables are kept between searches
+   material_thread(thread->id);
+   sort_init();
+
+   // iterative deepening, odd threads start one ply deeper to spread the work
+
+   if (setjmp(SearchInfo->buf) == 0) {
+
+      list_copy(SearchRoot->list,SearchInput->list);
+
+      for (depth = 1 + thread->id % 2; depth < DepthMax && !SearchThreadStop; depth++) {
+         board_copy(SearchCurrent->board,SearchInput->board);
+         search_full_root(SearchRoot->list,SearchCurrent->board,depth,SearchNormal);
+      }
+   }
+
+   thread->node_nb = SearchCurrent->node_nb;
+
+   return NULL;
+}
+
+// search_thread_nodes()
+
+static void search_thread_nodes() {
+
+   int id;
+   sint64 node_nb;
+
+   // add the helper nodes to the main thread count (used for display only)
+
+   if (SearchInfo->thread_id != 0) return;
+
+   for (id = 1; id < SearchThreadNb; id++) {
+      node_nb = SearchThread[id].node_nb;
+      SearchCurrent->node_nb += node_nb - SearchThread[id].node_seen;
+      SearchThread[id].node_seen = node_nb;
    }
 }
 
@@ -40,6 +40,8 @@ namespace engine {
 const int DepthMax = 64;
 const int HeightMax = 256;
 
+const int ThreadMax = 64;
+
 const int SearchNormal = 0;
 const int SearchShort  = 1;
 
@@ -68,6 +70,7 @@ struct search_info_t {
    int check_nb;
    int check_inc;
    double last_time;
+   int thread_id; // 0 = main thread, > 0 = helper thread
 };
 
 struct search_root_t {
@@ -104,11 +107,13 @@ struct search_current_t {
 
 // variables
 
+// SearchInput is shared, the rest is private to each search thread
+
 extern search_input_t SearchInput[1];
-extern search_info_t SearchInfo[1];
-extern search_best_t SearchBest[1];
-extern search_root_t SearchRoot[1];
-extern search_current_t SearchCurrent[1];
+extern thread_local search_info_t SearchInfo[1];
+extern thread_local search_best_t SearchBest[1];
+extern thread_local search_root_t SearchRoot[1];
+extern thread_local search_current_t SearchCurrent[1];
 
 // functions
 
@@ -573,6 +573,12 @@ static int full_search(board_t * board, int alpha, int beta, int depth, int heig
 
    while ((move=sort_next(sort)) != MoveNone) {
 
+      // prefetch the child's trans-table cluster, the extension and pruning
+      // tests below then hide the memory latency (children at depth <= 0
+      // go straight to the quiescence search, which does not probe)
+
+      if (UseTrans && depth > TransDepth) trans_prefetch(Trans,move_do_key(move,board));
+
       // extensions
 
       new_depth = full_new_depth(depth,move,board,single_reply,node_type==NodePV);
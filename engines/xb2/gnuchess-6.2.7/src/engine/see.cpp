@@ -38,6 +38,237 @@
 
 namespace engine {
 
+#if BITBOARD
+
+// prototypes
+
+static uint64 see_attack (const board_t * board, int to, uint64 occ);
+static int    see_swap   (const board_t * board, int to, uint64 attack, uint64 occ, int colour, int piece_value);
+
+// functions
+
+// see_move()
+
+int see_move(int move, const board_t * board) {
+
+   int att, def;
+   int from, to;
+   uint64 occ, attack;
+   int value, piece_value;
+   int piece, capture;
+
+   ASSERT(move_is_ok(move));
+   ASSERT(board!=NULL);
+
+   // init
+
+   from = MOVE_FROM(move);
+   to = MOVE_TO(move);
+
+   // move the piece
+
+   piece = board->square[from];
+   ASSERT(piece_is_ok(piece));
+
+   att = PIECE_COLOUR(piece);
+   def = COLOUR_OPP(att);
+
+   // promote
+
+   if (MOVE_IS_PROMOTE(move)) {
+      ASSERT(PIECE_IS_PAWN(piece));
+      piece = move_promote(move);
+      ASSERT(piece_is_ok(piece));
+      ASSERT(COLOUR_IS(piece,att));
+   }
+
+   piece_value = VALUE_PIECE(piece);
+
+   // lift the piece (uncovers hidden attackers)
+
+   occ = (board->bb_colour[White] | board->bb_colour[Black]) ^ SQUARE_BB(from);
+
+   // capture the piece
+
+   value = 0;
+
+   capture = board->square[to];
+
+   if (capture != Empty) {
+
+      ASSERT(piece_is_ok(capture));
+      ASSERT(COLOUR_IS(capture,def));
+
+      value += VALUE_PIECE(capture);
+   }
+
+   // promote
+
+   if (MOVE_IS_PROMOTE(move)) {
+      value += VALUE_PIECE(piece) - ValuePawn;
+   }
+
+   // en-passant
+
+   if (MOVE_IS_EN_PASSANT(move)) {
+      ASSERT(value==0);
+      ASSERT(PIECE_IS_PAWN(board->square[SQUARE_EP_DUAL(to)]));
+      value += ValuePawn;
+      occ ^= SQUARE_BB(SQUARE_EP_DUAL(to));
+   }
+
+   // attackers of both sides
+
+   attack = see_attack(board,to,occ) & occ;
+   if ((attack & board->bb_colour[def]) == 0) return value; // no defender => stop SEE
+
+   // SEE search
+
+   value -= see_swap(board,to,attack,occ,def,piece_value);
+
+   return value;
+}
+
+// see_square()
+
+int see_square(const board_t * board, int to, int colour) {
+
+   uint64 occ, attack;
+   int piece;
+
+   ASSERT(board!=NULL);
+   ASSERT(SQUARE_IS_OK(to));
+   ASSERT(COLOUR_IS_OK(colour));
+
+   ASSERT(COLOUR_IS(board->square[to],COLOUR_OPP(colour)));
+
+   // attackers of both sides
+
+   occ = board->bb_colour[White] | board->bb_colour[Black];
+
+   attack = see_attack(board,to,occ);
+   if ((attack & board->bb_colour[colour]) == 0) return 0; // no attacker => stop SEE
+
+   // captured piece
+
+   piece = board->square[to];
+   ASSERT(piece_is_ok(piece));
+   ASSERT(COLOUR_IS(piece,COLOUR_OPP(colour)));
+
+   // SEE search
+
+   return see_swap(board,to,attack,occ,colour,VALUE_PIECE(piece));
+}
+
+// see_attack()
+
+static uint64 see_attack(const board_t * board, int to, uint64 occ) {
+
+   int sq_64;
+   const uint64 * bb;
+
+   ASSERT(board!=NULL);
+   ASSERT(SQUARE_IS_OK(to));
+
+   sq_64 = SQUARE_TO_64(to);
+   bb = board->bb_piece;
+
+   return (PawnAttackBB[Black][sq_64] & bb[WhitePawn12])
+        | (PawnAttackBB[White][sq_64] & bb[BlackPawn12])
+        | (KnightAttackBB[sq_64] & (bb[WhiteKnight12] | bb[BlackKnight12]))
+        | (KingAttackBB[sq_64] & (bb[WhiteKing12] | bb[BlackKing12]))
+        | (bishop_attack(sq_64,occ) & (bb[WhiteBishop12] | bb[BlackBishop12] | bb[WhiteQueen12] | bb[BlackQueen12]))
+        | (rook_attack(sq_64,occ) & (bb[WhiteRook12] | bb[BlackRook12] | bb[WhiteQueen12] | bb[BlackQueen12]));
+}
+
+// see_swap()
+
+static int see_swap(const board_t * board, int to, uint64 attack, uint64 occ, int colour, int piece_value) {
+
+   int sq_64;
+   const uint64 * bb;
+   int gain[32];
+   int size;
+   int piece_12, piece;
+   uint64 from;
+   int value;
+
+   ASSERT(board!=NULL);
+   ASSERT(SQUARE_IS_OK(to));
+   ASSERT(COLOUR_IS_OK(colour));
+   ASSERT(piece_value>0);
+
+   // iterative version of the recursive ray-walking SEE (same values),
+   // gain[i] is what the i-th capture wins if not answered
+
+   sq_64 = SQUARE_TO_64(to);
+   bb = board->bb_piece;
+
+   size = 0;
+   value = 0; // no more attackers
+
+   while (true) {
+
+      // find the least valuable attacker
+
+      attack &= occ;
+
+      for (piece_12 = WhitePawn12 + colour; piece_12 <= BlackKing12; piece_12 += 2) { // HACK: MV order
+         from = attack & bb[piece_12];
+         if (from != 0) break;
+      }
+
+      if (piece_12 > BlackKing12) break; // no more attackers
+
+      if (piece_value == ValueKing) { // do not allow an answer to a king capture
+         value = ValueKing;
+         break;
+      }
+
+      // capture
+
+      ASSERT(size<32);
+      gain[size] = piece_value;
+
+      piece = PieceFrom12[piece_12];
+      piece_value = VALUE_PIECE(piece);
+
+      if (piece_value == ValuePawn && SQUARE_IS_PROMOTE(to)) { // HACK: PIECE_IS_PAWN(piece)
+         ASSERT(PIECE_IS_PAWN(piece));
+         piece_value = ValueQueen;
+         gain[size] += ValueQueen - ValuePawn;
+      }
+
+      size++;
+
+      // lift the attacker and add the slider hidden behind it, if any
+
+      occ ^= from & (~from + 1); // lowest bit
+
+      if (PIECE_IS_PAWN(piece) || (piece & (BishopFlag|KingFlag)) != 0) {
+         attack |= bishop_attack(sq_64,occ) & (bb[WhiteBishop12] | bb[BlackBishop12] | bb[WhiteQueen12] | bb[BlackQueen12]);
+      }
+
+      if ((piece & (RookFlag|KingFlag)) != 0) {
+         attack |= rook_attack(sq_64,occ) & (bb[WhiteRook12] | bb[BlackRook12] | bb[WhiteQueen12] | bb[BlackQueen12]);
+      }
+
+      colour = COLOUR_OPP(colour);
+   }
+
+   // negamax back to the first capture (each side can stop capturing)
+
+   while (size > 0) {
+      size--;
+      value = gain[size] - value;
+      if (value < 0) value = 0;
+   }
+
+   return value;
+}
+
+#else
+
 // types
 
 struct alist_t {
@@ -413,6 +644,8 @@ static int alist_pop(alist_t * alist, const board_t * board) {
    return sq;
 }
 
+#endif
+
 }  // namespace engine
 
 // end of see.cpp
@@ -89,22 +89,22 @@ enum test_t {
    TEST_CHECK_QS
 };
 
-// variables
+// variables (per search thread, see sort_init())
 
-static int PosLegalEvasion;
-static int PosSEE;
+static thread_local int PosLegalEvasion;
+static thread_local int PosSEE;
 
-static int PosEvasionQS;
-static int PosCheckQS;
-static int PosCaptureQS;
+static thread_local int PosEvasionQS;
+static thread_local int PosCheckQS;
+static thread_local int PosCaptureQS;
 
-static int Code[CODE_SIZE];
+static thread_local int Code[CODE_SIZE];
 
-static uint16 Killer[HeightMax][KillerNb];
+static thread_local uint16 Killer[HeightMax][KillerNb];
 
-static uint16 History[HistorySize];
-static uint16 HistHit[HistorySize];
-static uint16 HistTot[HistorySize];
+static thread_local uint16 History[HistorySize];
+static thread_local uint16 HistHit[HistorySize];
+static thread_local uint16 HistTot[HistorySize];
 
 // prototypes
 
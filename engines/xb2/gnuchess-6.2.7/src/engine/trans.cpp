@@ -23,9 +23,12 @@
 
 // includes
 
+#include <cstring>
+
 #include "hash.h"
 #include "move.h"
 #include "option.h"
+#include "posix.h"
 #include "protocol.h"
 #include "trans.h"
 #include "util.h"
@@ -40,11 +43,11 @@ namespace engine {
 
 // constants
 
-static const bool UseModulo = false;
-
 static const int DateSize = 16;
 
-static const int ClusterSize = 4; // TODO: unsigned?
+static const int ClusterSize = 4; // 4 x 16 bytes = one 64-byte cache line
+
+static const int FullSample = 1000; // clusters sampled for "hashfull"
 
 static const int DepthNone = -128;
 
@@ -65,11 +68,13 @@ struct entry_t {
 
 struct trans { // HACK: typedef'ed in trans.h
    entry_t * table;
-   uint32 size;
-   uint32 mask;
+   uint64 size; // entries
+   uint64 cluster_nb;
    int date;
    int age[DateSize];
-   uint32 used;
+};
+
+struct trans_stat_t {
    sint64 read_nb;
    sint64 read_hit;
    sint64 write_nb;
@@ -81,6 +86,11 @@ struct trans { // HACK: typedef'ed in trans.h
 
 trans_t Trans[1];
 
+// counters are per thread so that search threads do not fight over one cache
+// line, the main thread's figures are reported (and reset every search)
+
+static thread_local trans_stat_t TransStat[1];
+
 // prototypes
 
 static void      trans_set_date (trans_t * trans, int date);
@@ -88,6 +98,9 @@ static int       trans_age      (const trans_t * trans, int date);
 
 static entry_t * trans_entry    (trans_t * trans, uint64 key);
 
+static uint32    entry_lock     (const entry_t * entry);
+static void      entry_seal     (entry_t * entry, uint64 key);
+
 static bool      entry_is_ok    (const entry_t * entry);
 
 // functions
@@ -102,7 +115,7 @@ bool trans_is_ok(const trans_t * trans) {
 
    if (trans->table == NULL) return false;
    if (trans->size == 0) return false;
-   if (trans->mask == 0 || trans->mask >= trans->size) return false;
+   if (trans->cluster_nb == 0 || trans->size != trans->cluster_nb * ClusterSize) return false;
    if (trans->date >= DateSize) return false;
 
    for (date = 0; date < DateSize; date++) {
@@ -121,7 +134,7 @@ void trans_init(trans_t * trans) {
    ASSERT(sizeof(entry_t)==16);
 
    trans->size = 0;
-   trans->mask = 0;
+   trans->cluster_nb = 0;
    trans->table = NULL;
 
    trans_set_date(trans,0);
@@ -135,31 +148,25 @@ void trans_init(trans_t * trans) {
 
 void trans_alloc(trans_t * trans) {
 
-   uint32 size, target;
+   uint64 target;
 
    ASSERT(trans!=NULL);
 
-   // calculate size
+   // calculate size, any number of clusters will do (see trans_entry())
 
    target = option_get_int("Hash");
    if (target < 4) target = 16;
    target *= 1024 * 1024;
 
-   for (size = 1; size != 0 && size <= target; size *= 2)
-      ;
-
-   size /= 2;
-   ASSERT(size>0&&size<=target);
+   trans->cluster_nb = target / (ClusterSize * sizeof(entry_t));
+   if (trans->cluster_nb > (uint64(1) << 32)) trans->cluster_nb = uint64(1) << 32; // 32-bit index
+   ASSERT(trans->cluster_nb>0);
 
-   // allocate table
+   trans->size = trans->cluster_nb * ClusterSize;
 
-   size /= sizeof(entry_t);
-   ASSERT(size!=0&&(size&(size-1))==0); // power of 2
+   // allocate table (page-aligned, so clusters never straddle a cache line)
 
-   trans->size = size + (ClusterSize - 1); // HACK to avoid testing for end of table
-   trans->mask = size - 1;
-
-   trans->table = (entry_t *) my_malloc(trans->size*sizeof(entry_t));
+   trans->table = (entry_t *) large_alloc(trans->size*sizeof(entry_t),option_get_bool("Huge Pages"));
 
    trans_clear(trans);
 
@@ -172,11 +179,11 @@ void trans_free(trans_t * trans) {
 
    ASSERT(trans_is_ok(trans));
 
-   my_free(trans->table);
+   large_free(trans->table,trans->size*sizeof(entry_t));
 
    trans->table = NULL;
    trans->size = 0;
-   trans->mask = 0;
+   trans->cluster_nb = 0;
 }
 
 // trans_clear()
@@ -185,7 +192,7 @@ void trans_clear(trans_t * trans) {
 
    entry_t clear_entry[1];
    entry_t * entry;
-   uint32 index;
+   uint64 index;
 
    ASSERT(trans!=NULL);
 
@@ -233,12 +240,11 @@ static void trans_set_date(trans_t * trans, int date) {
       trans->age[date] = trans_age(trans,date);
    }
 
-   trans->used = 0;
-   trans->read_nb = 0;
-   trans->read_hit = 0;
-   trans->write_nb = 0;
-   trans->write_hit = 0;
-   trans->write_collision = 0;
+   TransStat->read_nb = 0;
+   TransStat->read_hit = 0;
+   TransStat->write_nb = 0;
+   TransStat->write_hit = 0;
+   TransStat->write_collision = 0;
 }
 
 // trans_age()
@@ -263,6 +269,7 @@ static int trans_age(const trans_t * trans, int date) {
 void trans_store(trans_t * trans, uint64 key, int move, int depth, int min_value, int max_value) {
 
    entry_t * entry, * best_entry;
+   entry_t copy[1];
    int score, best_score;
    int i;
 
@@ -275,7 +282,7 @@ void trans_store(trans_t * trans, uint64 key, int move, int depth, int min_value
 
    // init
 
-   trans->write_nb++;
+   TransStat->write_nb++;
 
    // probe
 
@@ -286,33 +293,37 @@ void trans_store(trans_t * trans, uint64 key, int move, int depth, int min_value
 
    for (i = 0; i < ClusterSize; i++, entry++) {
 
-      if (entry->lock == KEY_LOCK(key)) {
+      *copy = *entry; // other search threads may write the entry concurrently
+
+      if (entry_lock(copy) == KEY_LOCK(key)) {
 
          // hash hit => update existing entry
 
-         trans->write_hit++;
-         if (entry->date != trans->date) trans->used++;
+         TransStat->write_hit++;
 
-         entry->date = trans->date;
+         copy->date = trans->date;
 
-         if (depth > entry->depth) entry->depth = depth; // for replacement scheme
+         if (depth > copy->depth) copy->depth = depth; // for replacement scheme
 
-         if (move != MoveNone && depth >= entry->move_depth) {
-            entry->move_depth = depth;
-            entry->move = move;
+         if (move != MoveNone && depth >= copy->move_depth) {
+            copy->move_depth = depth;
+            copy->move = move;
          }
 
-         if (min_value > -ValueInf && depth >= entry->min_depth) {
-            entry->min_depth = depth;
-            entry->min_value = min_value;
+         if (min_value > -ValueInf && depth >= copy->min_depth) {
+            copy->min_depth = depth;
+            copy->min_value = min_value;
          }
 
-         if (max_value < +ValueInf && depth >= entry->max_depth) {
-            entry->max_depth = depth;
-            entry->max_value = max_value;
+         if (max_value < +ValueInf && depth >= copy->max_depth) {
+            copy->max_depth = depth;
+            copy->max_value = max_value;
          }
 
-         ASSERT(entry_is_ok(entry));
+         ASSERT(entry_is_ok(copy));
+
+         entry_seal(copy,key);
+         *entry = *copy;
 
          return;
       }
@@ -332,32 +343,30 @@ void trans_store(trans_t * trans, uint64 key, int move, int depth, int min_value
 
    entry = best_entry;
    ASSERT(entry!=NULL);
-   ASSERT(entry->lock!=KEY_LOCK(key));
 
-   if (entry->date == trans->date) {
-      trans->write_collision++;
-   } else {
-      trans->used++;
-   }
+   if (entry->date == trans->date) TransStat->write_collision++;
 
    // store
 
    ASSERT(entry!=NULL);
 
-   entry->lock = KEY_LOCK(key);
-   entry->date = trans->date;
+   copy->date = trans->date;
+
+   copy->depth = depth;
 
-   entry->depth = depth;
+   copy->move_depth = (move != MoveNone) ? depth : DepthNone;
+   copy->move = move;
+   copy->flags = 0;
 
-   entry->move_depth = (move != MoveNone) ? depth : DepthNone;
-   entry->move = move;
+   copy->min_depth = (min_value > -ValueInf) ? depth : DepthNone;
+   copy->max_depth = (max_value < +ValueInf) ? depth : DepthNone;
+   copy->min_value = min_value;
+   copy->max_value = max_value;
 
-   entry->min_depth = (min_value > -ValueInf) ? depth : DepthNone;
-   entry->max_depth = (max_value < +ValueInf) ? depth : DepthNone;
-   entry->min_value = min_value;
-   entry->max_value = max_value;
+   ASSERT(entry_is_ok(copy));
 
-   ASSERT(entry_is_ok(entry));
+   entry_seal(copy,key);
+   *entry = *copy;
 }
 
 // trans_retrieve()
@@ -365,6 +374,7 @@ void trans_store(trans_t * trans, uint64 key, int move, int depth, int min_value
 bool trans_retrieve(trans_t * trans, uint64 key, int * move, int * min_depth, int * max_depth, int * min_value, int * max_value) {
 
    entry_t * entry;
+   entry_t copy[1];
    int i;
 
    ASSERT(trans_is_ok(trans));
@@ -376,7 +386,7 @@ bool trans_retrieve(trans_t * trans, uint64 key, int * move, int * min_depth, in
 
    // init
 
-   trans->read_nb++;
+   TransStat->read_nb++;
 
    // probe
 
@@ -384,19 +394,26 @@ bool trans_retrieve(trans_t * trans, uint64 key, int * move, int * min_depth, in
 
    for (i = 0; i < ClusterSize; i++, entry++) {
 
-      if (entry->lock == KEY_LOCK(key)) {
+      *copy = *entry; // other search threads may write the entry concurrently
+
+      if (entry_lock(copy) == KEY_LOCK(key)) {
 
          // found
 
-         trans->read_hit++;
-         if (entry->date != trans->date) entry->date = trans->date;
+         TransStat->read_hit++;
 
-         *move = entry->move;
+         if (copy->date != trans->date) {
+            copy->date = trans->date;
+            entry_seal(copy,key);
+            *entry = *copy;
+         }
+
+         *move = copy->move;
 
-         *min_depth = entry->min_depth;
-         *max_depth = entry->max_depth;
-         *min_value = entry->min_value;
-         *max_value = entry->max_value;
+         *min_depth = copy->min_depth;
+         *max_depth = copy->max_depth;
+         *min_value = copy->min_value;
+         *max_value = copy->max_value;
 
          return true;
       }
@@ -407,39 +424,97 @@ bool trans_retrieve(trans_t * trans, uint64 key, int * move, int * min_depth, in
    return false;
 }
 
+// trans_prefetch()
+
+void trans_prefetch(const trans_t * trans, uint64 key) {
+
+   // same mapping as trans_entry(), cluster is one cache line
+
+   PREFETCH(&trans->table[((uint64(KEY_INDEX(key)) * trans->cluster_nb) >> 32) * ClusterSize]);
+}
+
 // trans_stats()
 
 void trans_stats(const trans_t * trans) {
 
+   const entry_t * entry;
    double full;
-   // double hit, collision;
+   double hit, collision;
+   uint64 index, sample;
+   int used;
 
    ASSERT(trans_is_ok(trans));
 
-   full = double(trans->used) / double(trans->size);
-   // hit = double(trans->read_hit) / double(trans->read_nb);
-   // collision = double(trans->write_collision) / double(trans->write_nb);
+   // sample the start of the table rather than counting on every store
+
+   sample = MIN(uint64(FullSample),trans->cluster_nb) * ClusterSize;
+   used = 0;
+
+   for (index = 0; index < sample; index++) {
+      entry = &trans->table[index];
+      if (entry->date == trans->date && (entry->lock != 0 || entry->depth != DepthNone)) used++; // cleared entries have date 0
+   }
+
+   full = double(used) / double(sample);
 
    send("info hashfull %.0f",full*1000.0);
+
+   if (option_get_bool("Hash Statistics")) {
+
+      hit = (TransStat->read_nb > 0) ? double(TransStat->read_hit) / double(TransStat->read_nb) : 0.0;
+      collision = (TransStat->write_nb > 0) ? double(TransStat->write_collision) / double(TransStat->write_nb) : 0.0;
+
+      send("info string hashstats mb=" S64_FORMAT " clusters=" S64_FORMAT " full=%.3f read=" S64_FORMAT " read_hit=" S64_FORMAT " hit=%.4f write=" S64_FORMAT " write_hit=" S64_FORMAT " write_collision=" S64_FORMAT " collision=%.4f",
+           sint64(trans->size*sizeof(entry_t)>>20),sint64(trans->cluster_nb),full,
+           TransStat->read_nb,TransStat->read_hit,hit,
+           TransStat->write_nb,TransStat->write_hit,TransStat->write_collision,collision);
+   }
 }
 
 // trans_entry()
 
 static entry_t * trans_entry(trans_t * trans, uint64 key) {
 
-   uint32 index;
+   uint64 index;
 
    ASSERT(trans_is_ok(trans));
 
-   if (UseModulo) {
-      index = KEY_INDEX(key) % (trans->mask + 1);
-   } else {
-      index = KEY_INDEX(key) & trans->mask;
-   }
+   // multiply-shift maps the 32-bit index onto [0,cluster_nb) without a
+   // division, so the table size need not be a power of two
+
+   index = (uint64(KEY_INDEX(key)) * trans->cluster_nb) >> 32;
+
+   ASSERT(index<trans->cluster_nb);
+
+   return &trans->table[index*ClusterSize];
+}
+
+// entry_lock()
+
+static uint32 entry_lock(const entry_t * entry) {
+
+   uint32 word[4];
+
+   ASSERT(entry!=NULL);
+
+   // the stored lock is XORed with the data, so that an entry torn by two
+   // threads writing at the same time does not match any key (lockless SMP)
+
+   memcpy(word,entry,sizeof(word));
+
+   return word[0] ^ word[1] ^ word[2] ^ word[3];
+}
+
+// entry_seal()
+
+static void entry_seal(entry_t * entry, uint64 key) {
+
+   ASSERT(entry!=NULL);
 
-   ASSERT(index<=trans->mask);
+   entry->lock = 0;
+   entry->lock = KEY_LOCK(key) ^ entry_lock(entry);
 
-   return &trans->table[index];
+   ASSERT(entry_lock(entry)==KEY_LOCK(key));
 }
 
 // entry_is_ok()
@@ -52,6 +52,8 @@ extern void trans_inc_date (trans_t * trans);
 extern void trans_store    (trans_t * trans, uint64 key, int move, int depth, int min_value, int max_value);
 extern bool trans_retrieve (trans_t * trans, uint64 key, int * move, int * min_depth, int * max_depth, int * min_value, int * max_value);
 
+extern void trans_prefetch (const trans_t * trans, uint64 key);
+
 extern void trans_stats    (const trans_t * trans);
 
 }  // namespace engine
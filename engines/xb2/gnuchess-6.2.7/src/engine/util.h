@@ -43,6 +43,12 @@
 #  define DEBUG FALSE
 #endif
 
+#ifdef NO_BITBOARD // -DNO_BITBOARD: ray-walking attack detection only
+#  define BITBOARD FALSE
+#else
+#  define BITBOARD TRUE
+#endif
+
 #ifdef _MSC_VER
 #  define S64_FORMAT "%I64d"
 #  define U64_FORMAT "%016I64X"
@@ -61,6 +67,12 @@
 #  define U64(u) (u##ULL)
 #endif
 
+#if defined(__GNUC__)
+#  define PREFETCH(address) __builtin_prefetch(address)
+#else
+#  define PREFETCH(address)
+#endif
+
 #undef ASSERT
 #if DEBUG
 #  define ASSERT(a) { if (!(a)) my_fatal("file \"%s\", line %d, assertion \"" #a "\" failed\n",__FILE__,__LINE__); }
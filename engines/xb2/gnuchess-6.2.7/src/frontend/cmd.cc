@@ -164,6 +164,13 @@ void cmd_book(void)
       strcat( data, "add " );
       strcat( data, token[2] );
     }
+  } else if (tokeneq(token[1], "bench")) {
+    if (access(token[2], F_OK) < 0) {
+      printf(_("The syntax to time the PGN reader is:\n\n\tbook bench file.pgn\n"));
+      return;
+    }
+    strcat( data, "bench " );
+    strcat( data, token[2] );
   } else if (tokeneq (token[1], "on") || tokeneq(token[1], "prefer")) {
     strcpy( data, "book on" );
     printf(_("Book is now on.\n"));
@@ -378,6 +385,18 @@ void cmd_memory(void)
   }
 }
 
+void cmd_cores(void)
+{
+  int cores;
+  if ( sscanf( token[1], "%d", &cores ) == 1 && cores > 0 ) {
+    char data[MAXSTR]="";
+    sprintf( data, "cores %d", cores );
+    SetDataToEngine( data );
+  } else {
+    printf( _("Invalid number of cores.\n") );
+  }
+}
+
 /* Move now, not applicable */
 void cmd_movenow(void)
 {
@@ -829,6 +848,12 @@ Play the game of chess.\n\n"), stdout );
       fputs( _("\
  -g, --graphic      enable graphic mode\n"), stdout );
       fputs( _("\
+ -B[depth], --bench[=depth]   search the built-in bench positions and quit\n"), stdout );
+      fputs( _("\
+     --perft=depth  count legal move paths to depth and quit\n"), stdout );
+      fputs( _("\
+     --fen=fen      start position for --perft\n"), stdout );
+      fputs( _("\
 \n"), stdout );
       fputs( _("\
  Options xboard and post are accepted without leading dashes\n\
@@ -1035,6 +1060,7 @@ static const char * const helpstr[] = {
    gettext_noop(" Produces a help blurb corresponding to this list of commands."),
    "book",
    gettext_noop(" add - compiles book.bin from a pgn book file"),
+   gettext_noop(" bench - times reading a pgn book file, book.bin is not changed"),
    gettext_noop(" on - enables use of book (default)"),
    gettext_noop(" off - disables use of book"),
    gettext_noop(" worst - plays worst move from book"),
@@ -1100,6 +1126,8 @@ static const char * const helpstr[] = {
    gettext_noop(" off - disables the memory hash table"),
    "memory N",
    gettext_noop(" Sets the hash table to permit storage of N MB."),
+   "cores N",
+   gettext_noop(" Sets the number of search threads to N."),
    "null",
    gettext_noop(" on - enables using the null-move heuristic to speed up search"),
    gettext_noop(" off - disables using the null-move heuristic"),
@@ -1220,6 +1248,7 @@ const struct methodtable commands[] = {
   { "bk", cmd_bk },
   { "black", cmd_black },
   { "book", cmd_book },
+  { "cores", cmd_cores },
   { "depth", cmd_depth },
   { "easy", cmd_easy },
   { "edit", cmd_edit },
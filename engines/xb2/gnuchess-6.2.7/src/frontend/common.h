@@ -545,6 +545,7 @@ void cmd_go(void);
 void cmd_graphic(void);
 void cmd_hard(void);
 void cmd_hash(void);
+void cmd_cores(void);
 void cmd_help (void);
 void cmd_hint(void);
 void cmd_last(void);
@@ -107,7 +107,7 @@ int SendToEngine( char msg[] )
     msg[msg_size] = '\n';
     msg[msg_size+1] = '\0';
 
-    msg_count = write( pipefd_f2a[1], msg, msg_size+1 );
+    msg_count = ChannelWrite( pipefd_f2a[1], msg, msg_size+1 );
 
     if (msg_count == -1)
       outError = errno;
@@ -133,24 +133,19 @@ int ReadFromEngine( void )
 {
 
   int nread=0;
-  fd_set set[1];
-  struct timeval time_val[1];
+  int ready;
   int engineinputready=0;
   char engineinputaux[BUF_SIZE]="";
 
   /* Poll input from engine in non-blocking mode */
-  FD_ZERO(set);
-  FD_SET( pipefd_a2f[0],set);
-  time_val->tv_sec = 0;
-  time_val->tv_usec = 0;
-  engineinputready = select( pipefd_a2f[0]+1, set, NULL, NULL, time_val );
+  engineinputready = PollInput( 1, &pipefd_a2f[0], &ready, 0 );
 
   if ( engineinputready == -1 ) {
     printf( "Error reading engine input.\n" );
   } else if ( engineinputready > 0 ) {
     /* There are some data from the engine. Store it in buffer */
     strncpy( engineinputaux, zerochar, BUF_SIZE );
-    nread = read( pipefd_a2f[0], engineinputaux, BUF_SIZE );
+    nread = ChannelRead( pipefd_a2f[0], engineinputaux, BUF_SIZE );
     /*write( STDOUT_FILENO, engineinputaux, BUF_SIZE );*/
     strcat( engineinputbuf, engineinputaux );
     engineinputbuf[strlen( engineinputbuf ) + nread] = '\0';
@@ -516,7 +511,7 @@ void ForwardUserInputToEngine( void )
     userinputaux[nread+1] = '\0';
     int outError=0;
     int msg_count=0;
-    msg_count = write( pipefd_a2e[1], userinputaux, nread+1 );
+    msg_count = ChannelWrite( pipefd_a2e[1], userinputaux, nread+1 );
     if (msg_count == -1)
       outError = errno;
     else
@@ -536,24 +531,19 @@ void ForwardEngineOutputToUser( void )
 {
 
   int nread=0;
-  fd_set set[1];
-  struct timeval time_val[1];
+  int ready;
   int engineinputready=0;
   char engineinputaux[BUF_SIZE]="";
 
   /* Poll input from engine in non-blocking mode */
-  FD_ZERO(set);
-  FD_SET( pipefd_e2a[0],set);
-  time_val->tv_sec = 0;
-  time_val->tv_usec = 0;
-  engineinputready = select( pipefd_e2a[0]+1, set, NULL, NULL, time_val );
+  engineinputready = PollInput( 1, &pipefd_e2a[0], &ready, 0 );
 
   if ( engineinputready == -1 ) {
     printf( "Error reading engine input.\n" );
   } else if ( engineinputready > 0 ) {
     /* There are some data from the engine. Read the data */
     strncpy( engineinputaux, zerochar, BUF_SIZE );
-    nread = read( pipefd_e2a[0], engineinputaux, BUF_SIZE );
+    nread = ChannelRead( pipefd_e2a[0], engineinputaux, BUF_SIZE );
     /* Write data to output */
     assert( nread < BUF_SIZE-1 );
     engineinputaux[nread] = '\0';
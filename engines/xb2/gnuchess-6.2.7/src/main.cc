@@ -243,8 +243,10 @@ int main (int argc, char *argv[])
 
   int c;
   int opt_help = 0, opt_version = 0, opt_post = 0, opt_xboard = 0, opt_memory = 0,
-      opt_easy = 0, opt_manual = 0, opt_quiet = 0, opt_uci = 0, opt_graphic = 0;
+      opt_easy = 0, opt_manual = 0, opt_quiet = 0, opt_uci = 0, opt_graphic = 0,
+      opt_bench = 0, opt_bench_depth = 0, opt_perft = 0;
   char opt_addbook[MAXSTR+1] = "";
+  char opt_fen[MAXSTR+1] = "";
   char *endptr;
 
   /*disable graphic output by default */
@@ -269,6 +271,9 @@ int main (int argc, char *argv[])
         {"uci", 0, 0, 'u'},
         {"addbook", 1, 0, 'a'},
         {"graphic", 0, 0, 'g'},
+        {"bench", 2, 0, 'B'},
+        {"perft", 1, 0, 'P'},
+        {"fen", 1, 0, 'F'},
         {0, 0, 0, 0}
     };
 
@@ -276,7 +281,7 @@ int main (int argc, char *argv[])
 
     int option_index = 0;
 
-    c = getopt_long (argc, argv, "qehmpvxgM:ua:",
+    c = getopt_long (argc, argv, "qehmpvxgM:ua:B::",
              long_options, &option_index);
 
     /* Detect the end of the options. */
@@ -344,6 +349,32 @@ int main (int argc, char *argv[])
        }
        strcpy( opt_addbook, optarg );
        break;
+     case 'B':
+       opt_bench = 1;
+       if ( optarg != NULL ) {
+         errno = 0; /* zero error indicator */
+         opt_bench_depth = strtol (optarg, &endptr, 10);
+         if ( errno != 0 || *endptr != '\0' || opt_bench_depth < 1 ){
+           printf(_("Depth out of range or invalid.\n"));
+           return(1);
+         }
+       }
+       break;
+     case 'P':
+       errno = 0; /* zero error indicator */
+       opt_perft = strtol (optarg, &endptr, 10);
+       if ( errno != 0 || *endptr != '\0' || opt_perft < 1 ){
+         printf(_("Depth out of range or invalid.\n"));
+         return(1);
+       }
+       break;
+     case 'F':
+       if ( strlen( optarg ) > MAXSTR ) {
+         printf( _("FEN is too long (max = %d).\n"), MAXSTR );
+         return(1);
+       }
+       strcpy( opt_fen, optarg );
+       break;
      default:
        puts (_("Option processing failed.\n"));
        abort();
@@ -385,7 +416,8 @@ int main (int argc, char *argv[])
 	return(0);
 
   /* Startup output */
-  if ( !( flags & XBOARD ) && ( !opt_quiet ) && ( !opt_uci) ) {
+  if ( !( flags & XBOARD ) && ( !opt_quiet ) && ( !opt_uci) &&
+       ( !opt_bench ) && ( !opt_perft ) ) {
     printf ( _("\
 Copyright (C) %s Free Software Foundation, Inc.\n\
 License GPLv3+: GNU GPL version 3 or later <http://gnu.org/licenses/gpl.html>\n\
@@ -400,6 +432,21 @@ There is NO WARRANTY, to the extent permitted by law.\n"),
     return (1); /* Maybe an error if due to bad arguments. */
   }
 
+  /* Run the engine benchmark or a perft count without any UI and exit */
+  if ( opt_bench == 1 || opt_perft > 0 ) {
+    char data[MAXSTR+64]="";
+    if ( opt_bench == 1 ) {
+      sprintf( data, "bench %d", opt_bench_depth ); /* 0 => default depth */
+    } else if ( strlen( opt_fen ) > 0 ) {
+      sprintf( data, "position fen %s\nperft %d", opt_fen, opt_perft );
+    } else {
+      sprintf( data, "perft %d", opt_perft );
+    }
+    InitEngine();
+    RunEngineCommands( data );
+    return (0);
+  }
+
   dbg_open(NULL);
 
   if ( opt_memory != 0 )